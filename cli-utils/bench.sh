@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+
+# Time each stage of the algorithm on random instances of growing size.
+#
+# The sweep can be changed with the variables:
+#   BENCH_SIZES   SPECIESxCHARACTERS sizes (default: 25x10 ... 1600x640)
+#   BENCH_COUNT   instances of each kind for each size (default: 5)
+#   BENCH_ACTIVE  fraction of active characters (default: 0.1)
+#   BENCH_LOSSES  fraction of characters lost (default: 0.2)
+#   BENCH_REPEAT  runs of each stage, the fastest one is kept (default: 3)
+#   BENCH_OUTPUT  output file, one JSON object per line
+#                 (default: bench_results.jsonl)
+
+DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+cd $DIR/../
+
+SIZES=${BENCH_SIZES:-"25x10 50x20 100x40 200x80 400x160 800x320 1600x640"}
+COUNT=${BENCH_COUNT:-5}
+ACTIVE=${BENCH_ACTIVE:-0.1}
+LOSSES=${BENCH_LOSSES:-0.2}
+REPEAT=${BENCH_REPEAT:-3}
+OUTPUT=${BENCH_OUTPUT:-bench_results.jsonl}
+
+TMP="$(mktemp -d)"
+trap 'rm -rf "$TMP"' EXIT
+
+: > "$OUTPUT"
+
+for size in $SIZES; do
+	species=${size%x*}
+	characters=${size#*x}
+	losses=$(awk "BEGIN { print int($LOSSES * $characters) }")
+
+	printf 'Size %s: ' "$size"
+
+	for ((i = 0; i < COUNT; i++)); do
+		for kind in solvable unsolvable; do
+			file="$TMP/${size}_${kind}_$i.txt"
+			flag=$([ $kind = unsolvable ] && printf -- '--unsolvable')
+
+			bin/ppp-generate -s $species -c $characters -a $ACTIVE \
+				-l $losses --seed $i $flag "$file" || exit 1
+		done
+	done
+
+	bin/ppp-bench -n $REPEAT "$TMP"/${size}_*.txt >> "$OUTPUT" || exit 1
+
+	printf 'done\n'
+done
+
+printf '\nResults written to %s\n' "$OUTPUT"
+
+exit 0
@@ -0,0 +1,68 @@
+#include "arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+/**
+  @brief Arena of the calling thread
+*/
+static thread_local arena::Arena thread_arena;
+
+/**
+  @brief Number of Scopes open in the calling thread
+*/
+static thread_local size_t open_scopes = 0;
+
+//=============================================================================
+// Arena
+
+arena::Arena::Arena(const size_t block_size)
+    : block_size(std::max<size_t>(1, block_size)) {}
+
+void* arena::Arena::allocate(const size_t size, const size_t alignment) {
+  while (true) {
+    if (block == blocks.size()) {
+      // no block left: add one, twice as big as the last one (or big enough
+      // for size)
+      const auto last = (sizes.empty() ? block_size / 2 : sizes.back());
+      const auto new_size = std::max(2 * last, size + alignment);
+
+      blocks.emplace_back(new char[new_size]);
+      sizes.push_back(new_size);
+    }
+
+    const auto base = reinterpret_cast<uintptr_t>(blocks[block].get());
+    const auto start = (base + offset + alignment - 1) & ~(alignment - 1);
+
+    if (start + size <= base + sizes[block]) {
+      // size fits in the current block
+      offset = start + size - base;
+
+      return reinterpret_cast<void*>(start);
+    }
+
+    // size doesn't fit, move to the next block
+    block++;
+    offset = 0;
+  }
+}
+
+size_t arena::Arena::capacity() const {
+  return std::accumulate(sizes.cbegin(), sizes.cend(), size_t(0));
+}
+
+//=============================================================================
+// Scope
+
+arena::Arena* arena::scoped() {
+  return (open_scopes > 0 ? &thread_arena : nullptr);
+}
+
+arena::Scope::Scope() : arena(&thread_arena), mark(thread_arena.mark()) {
+  open_scopes++;
+}
+
+arena::Scope::~Scope() {
+  open_scopes--;
+  arena->release(mark);
+}
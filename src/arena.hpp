@@ -0,0 +1,212 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+//=============================================================================
+// Data structures
+
+namespace arena {
+
+/**
+  @brief Class used to represent a monotonic memory arena
+
+  Memory is taken from a list of blocks by moving an offset forward, and it's
+  never freed one allocation at a time: release moves the offset back to a
+  mark, which frees everything allocated after it at once. Blocks are kept
+  after a release, so an arena that has reached its peak size doesn't
+  allocate anymore.
+*/
+class Arena {
+ public:
+  /**
+    @brief Struct used to represent a position in the arena
+  */
+  struct Mark {
+    size_t block{};   ///< Index of the block
+    size_t offset{};  ///< Offset in the block
+  };
+
+  /**
+    @brief Build an empty arena
+
+    @param[in] block_size Size of the first block, in bytes
+  */
+  explicit Arena(const size_t block_size = 64 << 10);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+    @brief Return \e size bytes aligned to \e alignment
+
+    @param[in] size      Number of bytes
+    @param[in] alignment Alignment (a power of 2)
+
+    @return Pointer to the bytes
+  */
+  void* allocate(const size_t size, const size_t alignment);
+
+  /**
+    @brief Return the current position in the arena
+
+    @return Mark
+  */
+  Mark mark() const { return {block, offset}; }
+
+  /**
+    @brief Free everything allocated since \e m was taken
+
+    @param[in] m Mark
+  */
+  void release(const Mark& m) {
+    block = m.block;
+    offset = m.offset;
+  }
+
+  /**
+    @brief Free everything allocated in the arena (blocks are kept)
+  */
+  void reset() { release({}); }
+
+  /**
+    @brief Return the size of the blocks of the arena
+
+    @return Number of bytes
+  */
+  size_t capacity() const;
+
+ private:
+  std::vector<std::unique_ptr<char[]>> blocks{};  ///< Blocks
+  std::vector<size_t> sizes{};                    ///< Size of each block
+  size_t block{};                                 ///< Current block
+  size_t offset{};  ///< Offset of the first free byte in the current block
+  size_t block_size{};  ///< Size of the first block
+};
+
+/**
+  @brief Return the arena of the calling thread, if a Scope is open in it
+
+  @return Arena of the innermost Scope of the thread (or nullptr)
+*/
+Arena* scoped();
+
+/**
+  @brief Class used to free, at the end of a scope, the memory allocated from
+         the arena of the thread during the scope
+
+  Scopes are opened by each level of the reduction recursion, so the
+  temporaries of a level are freed together when the level ends. Objects
+  allocated in a Scope must not outlive it.
+*/
+class Scope {
+ public:
+  /**
+    @brief Open a scope in the arena of the calling thread
+  */
+  Scope();
+
+  /**
+    @brief Free the memory allocated since the scope was opened
+  */
+  ~Scope();
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  Arena* const arena;
+  const Arena::Mark mark;
+};
+
+/**
+  @brief Class used to allocate the elements of a container from the arena of
+         the Scope where the container was built
+
+  Containers built outside any Scope allocate from the heap. A container
+  built in a Scope must only grow in that Scope (not in the nested ones),
+  copies of a container take the arena of the Scope where they are made.
+*/
+template <typename T>
+class Allocator {
+ public:
+  typedef T value_type;
+
+  /**
+    @brief Build an allocator from the arena of the innermost Scope of the
+           calling thread, or from the heap if there is none
+  */
+  Allocator() : arena(scoped()) {}
+
+  template <typename U>
+  Allocator(const Allocator<U>& other) : arena(other.arena) {}
+
+  /**
+    @brief Return memory for \e n objects of type T
+
+    @param[in] n Number of objects
+
+    @return Pointer to the memory
+  */
+  T* allocate(const size_t n) {
+    if (arena)
+      return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  /**
+    @brief Free the memory at \e p (the arena frees it at the end of the
+           Scope)
+
+    @param[in] p Pointer to the memory
+  */
+  void deallocate(T* const p, const size_t) {
+    if (!arena) ::operator delete(p);
+  }
+
+  /**
+    @brief Return the allocator of a copy of the container
+
+    @return Allocator of the innermost Scope of the calling thread
+  */
+  Allocator select_on_container_copy_construction() const {
+    return Allocator();
+  }
+
+  Arena* arena;  ///< Arena (or nullptr for the heap)
+};
+
+template <typename T, typename U>
+inline bool operator==(const Allocator<T>& a, const Allocator<U>& b) {
+  return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const Allocator<T>& a, const Allocator<U>& b) {
+  return a.arena != b.arena;
+}
+
+//=============================================================================
+// Typedefs used for readabily
+
+/**
+  List allocated from an arena
+*/
+template <typename T>
+using List = std::list<T, Allocator<T>>;
+
+/**
+  Map allocated from an arena
+*/
+template <typename K, typename V>
+using Map = std::map<K, V, std::less<K>, Allocator<std::pair<const K, V>>>;
+
+};
+
+#endif  // ARENA_HPP
@@ -0,0 +1,221 @@
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <memory>
+#include "functions.hpp"
+
+/**
+  @brief Return the nanoseconds taken by \e f, run \e repeat times (the
+         fastest run is kept)
+
+  @param[in] repeat Number of runs
+  @param[in] f      Function, called with the index of the run
+
+  @return Nanoseconds
+*/
+template <typename F>
+static uint64_t time_ns(const size_t repeat, F f) {
+  uint64_t best = UINT64_MAX;
+
+  for (size_t i = 0; i < repeat; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    f(i);
+    const auto end = std::chrono::steady_clock::now();
+
+    const uint64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count();
+    best = std::min(best, ns);
+  }
+
+  return best;
+}
+
+/**
+  @brief Return \e s as a JSON string
+
+  @param[in] s String
+
+  @return JSON string
+*/
+static std::string json_string(const std::string& s) {
+  std::string out = "\"";
+
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+
+  return out + "\"";
+}
+
+/**
+  @brief Time each stage of the algorithm on the graph in \e file, and return
+         the results as a JSON object
+
+  The stages after read_graph are timed on the graph cleaned from singletons,
+  as reduce does before anything else: maximal_reducible_graph,
+  hasse_diagram, initial_states, realize (the characters of the first safe
+  source, if any) and the whole reduce.
+
+  @param[in] file   Filename
+  @param[in] repeat Number of runs of each stage
+
+  @return JSON object
+*/
+static std::string bench_file(const std::string& file, const size_t repeat) {
+  std::vector<RBGraph> reads(repeat);
+  const auto t_read =
+      time_ns(repeat, [&](size_t i) { read_graph(file, reads[i]); });
+
+  RBGraph g;
+  copy_graph(reads[0], g);
+  reads.clear();
+
+  const auto num_s = num_species(g), num_c = num_characters(g);
+
+  remove_singletons(g);
+
+  // graphs are built in place, as moving them would invalidate their maps
+  std::vector<std::unique_ptr<RBGraph>> gms;
+  const auto t_maximal = time_ns(repeat, [&](size_t) {
+    gms.emplace_back(new RBGraph(maximal_reducible_graph(g, true)));
+  });
+
+  auto& gm = *gms.front();
+
+  std::vector<HDGraph> hasse(repeat);
+  const auto t_hasse =
+      time_ns(repeat, [&](size_t i) { hasse_diagram(hasse[i], g, gm); });
+
+  std::list<HDVertex> sources;
+  const auto t_initial =
+      time_ns(repeat, [&](size_t) { sources = initial_states(hasse[0]); });
+
+  uint64_t t_realize = 0;
+
+  if (!sources.empty()) {
+    std::list<SignedCharacter> lsc;
+    for (const auto& ci : hasse[0][sources.front()].characters) {
+      lsc.push_back({ci, State::gain});
+    }
+
+    std::vector<RBGraph> copies(repeat);
+    for (auto& copy : copies) copy_graph(g, copy);
+
+    t_realize = time_ns(repeat, [&](size_t i) { realize(lsc, copies[i]); });
+  }
+
+  bool reducible = false;
+  std::vector<RBGraph> copies(repeat);
+  for (auto& copy : copies) copy_graph(g, copy);
+
+  const auto t_reduce = time_ns(repeat, [&](size_t i) {
+    std::tie(std::ignore, reducible) = try_reduce(copies[i]);
+  });
+
+  std::stringstream json;
+  json << "{\"file\": " << json_string(file) << ", \"species\": " << num_s
+       << ", \"characters\": " << num_c
+       << ", \"reducible\": " << (reducible ? "true" : "false")
+       << ", \"sources\": " << sources.size()
+       << ", \"ns\": {\"read_graph\": " << t_read
+       << ", \"maximal_reducible_graph\": " << t_maximal
+       << ", \"hasse_diagram\": " << t_hasse
+       << ", \"initial_states\": " << t_initial
+       << ", \"realize\": " << t_realize << ", \"reduce\": " << t_reduce
+       << "}}";
+
+  return json.str();
+}
+
+int main(int argc, const char* argv[]) {
+  // declare the input files
+  std::vector<std::string> files;
+
+  // initialize options menu
+  boost::program_options::options_description general_options(
+      "Usage: ppp-bench [OPTION...] FILE..."
+      "\n"
+      "Time each stage of the algorithm on the graph in each FILE, and write "
+      "one JSON object for each FILE, on its own line, with the nanoseconds "
+      "taken by each stage."
+      "\n\n"
+      "Options");
+
+  general_options.add_options()
+      // option: help message
+      ("help,h", "Display this message.\n")
+      // option: repeat, runs of each stage
+      ("repeat,n", boost::program_options::value<size_t>()->default_value(3),
+       "Run each stage N times, and keep the fastest run.\n");
+
+  // initialize hidden options (not shown in --help)
+  boost::program_options::options_description hidden_options;
+  // option: input files
+  hidden_options.add_options()(
+      "files", boost::program_options::value<std::vector<std::string>>(&files));
+
+  // initialize positional options
+  boost::program_options::positional_options_description positional_options;
+  // add input files to the positional options
+  positional_options.add("files", -1);
+
+  // initialize options
+  boost::program_options::options_description cmdline_options;
+  // add the options menu and the hidden options to the available options
+  cmdline_options.add(general_options).add(hidden_options);
+
+  // initialize the variables map
+  boost::program_options::variables_map vm;
+
+  try {
+    // parse the options given in input, and check them against positional and
+    // cmdline options: store the result in vm
+    boost::program_options::store(
+        boost::program_options::command_line_parser(argc, argv)
+            .positional(positional_options)
+            .options(cmdline_options)
+            .run(),
+        vm);
+
+    boost::program_options::notify(vm);
+  } catch (const std::exception& e) {
+    // error while parsing the options given in input
+    std::cerr << "Error: " << e.what() << "." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    // help
+    std::cout << general_options << std::endl;
+
+    return 0;
+  }
+
+  if (files.empty()) {
+    // input files not specified
+    std::cerr << "Error: No input file specified." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  const auto repeat = std::max<size_t>(1, vm["repeat"].as<size_t>());
+  int ret = 0;
+
+  for (const auto& file : files) {
+    try {
+      std::cout << bench_file(file, repeat) << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << "Error: " << file << ": " << e.what() << "." << std::endl;
+
+      ret = 1;
+    }
+  }
+
+  return ret;
+}
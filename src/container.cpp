@@ -0,0 +1,349 @@
+#include "container.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+  @brief Magic bytes at the start of a container
+*/
+static const char container_magic[4] = {'P', 'P', 'P', 'C'};
+
+/**
+  @brief Version of the container format written by write_container
+*/
+static constexpr uint32_t container_version = 1;
+
+/**
+  @brief Size of the header of a container: magic, version and number of
+         instances
+*/
+static constexpr size_t container_header_size = 16;
+
+/**
+  @brief Size of the entry of an instance in the index of a container
+*/
+static constexpr size_t container_entry_size = 16;
+
+/**
+  @brief Return the value stored in the 8 little-endian bytes at \e p
+
+  @param[in] p Bytes
+
+  @return Value
+*/
+static uint64_t get_le64(const unsigned char* p) {
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < 8; ++i) {
+    value |= uint64_t(p[i]) << (8 * i);
+  }
+
+  return value;
+}
+
+/**
+  @brief Store \e value in the \e size little-endian bytes at \e p
+
+  @param[in]  value Value
+  @param[in]  size  Number of bytes
+  @param[out] p     Bytes
+*/
+static void put_le(const uint64_t value, const size_t size, char* p) {
+  for (size_t i = 0; i < size; ++i) {
+    p[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+/**
+  @brief Read \e size bytes at \e offset of \e fd into \e p
+
+  @param[in]  fd     File descriptor
+  @param[out] p      Bytes
+  @param[in]  size   Number of bytes
+  @param[in]  offset Offset in the file
+
+  @return True if all the bytes have been read
+*/
+static bool read_at(const int fd, char* p, size_t size, off_t offset) {
+  while (size > 0) {
+    const auto n = pread(fd, p, size, offset);
+
+    if (n <= 0) return false;
+
+    p += n;
+    size -= n;
+    offset += n;
+  }
+
+  return true;
+}
+
+/**
+  @brief Check if \e fd is a container, and read its number of instances
+
+  Throws std::runtime_error if the header of the container is corrupted.
+
+  @param[in]  fd          File descriptor
+  @param[in]  filename    Filename
+  @param[out] n_instances Number of instances
+
+  @return True if \e fd is a container
+*/
+static bool read_container_header(const int fd, const std::string& filename,
+                                  size_t& n_instances) {
+  unsigned char header[container_header_size];
+
+  if (!read_at(fd, reinterpret_cast<char*>(header), sizeof(header), 0) ||
+      std::memcmp(header, container_magic, sizeof(container_magic)) != 0)
+    return false;
+
+  uint32_t version = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    version |= uint32_t(header[4 + i]) << (8 * i);
+  }
+
+  if (version != container_version) {
+    // container parsing error
+    throw std::runtime_error("Failed to read container " + filename +
+                             ": unsupported container format version");
+  }
+
+  n_instances = get_le64(header + 8);
+
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 ||
+      n_instances > (st.st_size - container_header_size) /
+                        container_entry_size) {
+    // container parsing error
+    throw std::runtime_error("Failed to read container " + filename +
+                             ": truncated index");
+  }
+
+  return true;
+}
+
+//=============================================================================
+// InstanceReader
+
+InstanceReader::InstanceReader(const std::vector<std::string>& files,
+                               const size_t first, const size_t last,
+                               const size_t prefetch)
+    : files(files), prefetch(prefetch) {
+  offsets.push_back(0);
+
+  for (const auto& file : this->files) {
+    // for each file, count its instances
+    size_t n_instances = 1;
+    bool container = false;
+
+    const int file_fd = open(file.c_str(), O_RDONLY);
+
+    if (file_fd >= 0) {
+      try {
+        container = read_container_header(file_fd, file, n_instances);
+      } catch (...) {
+        close(file_fd);
+        throw;
+      }
+
+      close(file_fd);
+    }
+
+    if (!container) n_instances = 1;
+
+    containers.push_back(container);
+    n_containers += container;
+    offsets.push_back(offsets.back() + n_instances);
+  }
+
+  this->last = std::min(last, offsets.back());
+  this->first = std::min(first, this->last);
+  next_read = this->first;
+
+  if (prefetch > 0)
+    thread = std::thread(&InstanceReader::prefetch_instances, this);
+}
+
+InstanceReader::~InstanceReader() {
+  if (thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
+    }
+
+    changed.notify_all();
+    thread.join();
+  }
+
+  if (fd >= 0) close(fd);
+}
+
+std::string InstanceReader::name(const size_t i) const {
+  const auto index = first + i;
+  const auto f = std::upper_bound(offsets.cbegin(), offsets.cend(), index) -
+                 offsets.cbegin() - 1;
+
+  if (!containers[f]) return files[f];
+
+  return files[f] + ":" + std::to_string(index - offsets[f]);
+}
+
+bool InstanceReader::next(Instance& instance) {
+  if (prefetch == 0) {
+    if (next_read == last) return false;
+
+    instance = read(next_read++);
+
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]() { return !queue.empty() || next_read == last; });
+
+  if (queue.empty()) return false;
+
+  instance = std::move(queue.front());
+  queue.pop_front();
+
+  lock.unlock();
+  changed.notify_all();
+
+  return true;
+}
+
+Instance InstanceReader::read(const size_t i) {
+  Instance instance;
+  instance.name = name(i - first);
+
+  const auto f = std::upper_bound(offsets.cbegin(), offsets.cend(), i) -
+                 offsets.cbegin() - 1;
+
+  // input files are read by the caller
+  if (!containers[f]) return instance;
+
+  instance.contained = true;
+
+  if (fd < 0 || fd_file != size_t(f)) {
+    // open the container of the instance, closing the previous one
+    if (fd >= 0) close(fd);
+
+    fd = open(files[f].c_str(), O_RDONLY);
+    fd_file = f;
+
+    struct stat st;
+    fd_size = (fd >= 0 && fstat(fd, &st) == 0 ? st.st_size : 0);
+  }
+
+  // offset and size of the instance, from the index
+  unsigned char entry[container_entry_size];
+  const auto index = i - offsets[f];
+
+  if (fd < 0 ||
+      !read_at(fd, reinterpret_cast<char*>(entry), sizeof(entry),
+               container_header_size + index * container_entry_size)) {
+    instance.error = "Failed to read instance: no such instance";
+
+    return instance;
+  }
+
+  const auto offset = get_le64(entry);
+  const auto size = get_le64(entry + 8);
+
+  if (offset > fd_size || size > fd_size - offset) {
+    instance.error = "Failed to read instance: truncated container";
+
+    return instance;
+  }
+
+  instance.data.resize(size);
+
+  if (!read_at(fd, &instance.data[0], size, offset)) {
+    instance.data.clear();
+    instance.error = "Failed to read instance: truncated container";
+  }
+
+  return instance;
+}
+
+void InstanceReader::prefetch_instances() {
+  for (auto i = first; i < last; ++i) {
+    {
+      // wait for room in the queue
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock,
+                   [this]() { return stopped || queue.size() < prefetch; });
+
+      if (stopped) return;
+    }
+
+    auto instance = read(i);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(instance));
+      next_read = i + 1;
+    }
+
+    changed.notify_all();
+  }
+}
+
+//=============================================================================
+// General functions
+
+void write_container(const std::string& filename,
+                     const std::vector<std::string>& files) {
+  std::ofstream container(filename, std::ios::binary);
+
+  // header, then the index, filled after the contents of the files
+  std::vector<char> header(container_header_size +
+                           files.size() * container_entry_size);
+  std::memcpy(header.data(), container_magic, sizeof(container_magic));
+  put_le(container_version, 4, header.data() + 4);
+  put_le(files.size(), 8, header.data() + 8);
+
+  container.write(header.data(), header.size());
+
+  uint64_t offset = header.size();
+  std::vector<char> buffer(1 << 16);
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    // for each file, copy its contents to the container
+    std::ifstream file(files[i], std::ios::binary);
+
+    if (!file) {
+      throw std::runtime_error("Failed to read file " + files[i] +
+                               ": no such file or directory");
+    }
+
+    uint64_t size = 0;
+
+    while (file) {
+      file.read(buffer.data(), buffer.size());
+      container.write(buffer.data(), file.gcount());
+      size += file.gcount();
+    }
+
+    auto* const entry = header.data() + container_header_size +
+                        i * container_entry_size;
+    put_le(offset, 8, entry);
+    put_le(size, 8, entry + 8);
+
+    offset += size;
+  }
+
+  container.seekp(0);
+  container.write(header.data(), header.size());
+
+  if (!container) {
+    // output file error
+    throw std::runtime_error("Failed to write container to file: " +
+                             filename);
+  }
+}
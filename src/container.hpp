@@ -0,0 +1,160 @@
+#ifndef CONTAINER_HPP
+#define CONTAINER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//=============================================================================
+// Data structures
+
+/**
+  @brief Struct used to represent an instance read by an InstanceReader
+*/
+struct Instance {
+  std::string name{};   ///< Filename, or container filename and index
+  std::string data{};   ///< Contents of the instance, if it's in a container
+  std::string error{};  ///< Error while reading the instance, if any
+  bool contained{};     ///< True if the instance is in a container
+};
+
+/**
+  @brief Class used to read, in order, the instances in a list of files
+
+  Each file is either an input file, which is an instance by itself, or a
+  container of instances (see write_container), which is detected from its
+  first bytes.
+  Instances are numbered from 0 across all the files, and only the ones in a
+  range of indices are read, so that the same files can be split among
+  different runs.
+  Input files are not read, their filename is returned instead, while the
+  instances in a container are read with a single read each, through a file
+  descriptor kept open while the container is read.
+  If \e prefetch is not 0, a background thread reads up to \e prefetch
+  instances ahead of the caller, which bounds the memory used.
+*/
+class InstanceReader {
+ public:
+  /**
+    @brief Start reading the instances from \e first to \e last (excluded) in
+           \e files
+
+    Throws std::runtime_error if the header of a container can't be read.
+
+    @param[in] files    Filenames
+    @param[in] first    Index of the first instance
+    @param[in] last     Index after the last instance (clamped to the number
+                        of instances)
+    @param[in] prefetch Number of instances read ahead by a background thread
+                        (0 disables the thread)
+  */
+  InstanceReader(const std::vector<std::string>& files, const size_t first,
+                 const size_t last, const size_t prefetch);
+
+  /**
+    @brief Stop the background thread and close the open container
+  */
+  ~InstanceReader();
+
+  InstanceReader(const InstanceReader&) = delete;
+  InstanceReader& operator=(const InstanceReader&) = delete;
+
+  /**
+    @brief Return the number of instances in the range
+
+    @return Number of instances
+  */
+  inline size_t size() const { return last - first; }
+
+  /**
+    @brief Return true if at least one file is a container
+
+    @return True if at least one file is a container
+  */
+  inline bool has_containers() const { return n_containers > 0; }
+
+  /**
+    @brief Return the name of the instance \e i of the range: its filename,
+           or the filename of its container and its index in the container,
+           separated by ':'
+
+    @param[in] i Index of the instance in the range
+
+    @return Name of the instance
+  */
+  std::string name(const size_t i) const;
+
+  /**
+    @brief Read the next instance of the range into \e instance
+
+    Errors while reading the instance are stored in instance.error.
+
+    @param[out] instance Instance
+
+    @return False if there are no more instances
+  */
+  bool next(Instance& instance);
+
+ private:
+  /**
+    @brief Read the instance \e i (index across all the files)
+
+    @param[in] i Index of the instance
+
+    @return Instance
+  */
+  Instance read(const size_t i);
+
+  /**
+    @brief Read the instances of the range ahead of next, until the reader is
+           destroyed
+  */
+  void prefetch_instances();
+
+  std::vector<std::string> files{};  ///< Filenames
+  std::vector<size_t> offsets{};     ///< Index of the first instance of each
+                                     ///< file, and number of instances
+  std::vector<bool> containers{};    ///< True if the file is a container
+  size_t n_containers{};             ///< Number of containers
+
+  size_t first{};      ///< Index of the first instance of the range
+  size_t last{};       ///< Index after the last instance of the range
+  size_t next_read{};  ///< Index of the next instance read
+
+  int fd{-1};        ///< Descriptor of the open container
+  size_t fd_file{};  ///< Index of the open container in files
+  size_t fd_size{};  ///< Size of the open container
+
+  size_t prefetch{};                  ///< Number of instances read ahead
+  std::deque<Instance> queue{};       ///< Instances read ahead
+  bool stopped{};                     ///< Stop flag of the background thread
+  std::mutex mutex{};                 ///< Lock of queue, next_read and stopped
+  std::condition_variable changed{};  ///< Wakes up the caller and the thread
+  std::thread thread{};               ///< Background thread
+};
+
+//=============================================================================
+// General functions
+
+/**
+  @brief Write a container with the contents of \e files to \e filename
+
+  The container (all integers are little-endian) is made of:
+  - "PPPC" and the format version (4 bytes);
+  - number of instances (8 bytes);
+  - offset and size of each instance in the container (8 bytes each);
+  - contents of each file, as they are (text or binary format).
+
+  Throws std::runtime_error if a file can't be read or \e filename can't be
+  written.
+
+  @param[in] filename Filename of the container
+  @param[in] files    Filenames of the instances
+*/
+void write_container(const std::string& filename,
+                     const std::vector<std::string>& files);
+
+#endif  // CONTAINER_HPP
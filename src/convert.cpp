@@ -0,0 +1,106 @@
+#include <boost/program_options.hpp>
+#include "container.hpp"
+#include "rbgraph.hpp"
+
+int main(int argc, const char* argv[]) {
+  // declare the input and output files
+  std::vector<std::string> files;
+
+  // initialize options menu
+  boost::program_options::options_description general_options(
+      "Usage: ppp-convert [OPTION...] INPUT... OUTPUT"
+      "\n"
+      "Convert the matrix in INPUT (text or binary) to the binary format, or "
+      "to the text format, in OUTPUT, or pack the INPUT files in the "
+      "container OUTPUT."
+      "\n\n"
+      "Options");
+
+  general_options.add_options()
+      // option: help message
+      ("help,h", "Display this message.\n")
+      // option: text, write the text format
+      ("text,t", boost::program_options::bool_switch()->default_value(false),
+       "Write the text format instead of the binary format.\n")
+      // option: container, pack the input files in a container
+      ("container,c",
+       boost::program_options::bool_switch()->default_value(false),
+       "Pack the INPUT files, as they are, in the container OUTPUT.\n");
+
+  // initialize hidden options (not shown in --help)
+  boost::program_options::options_description hidden_options;
+  // option: input and output files
+  hidden_options.add_options()(
+      "files", boost::program_options::value<std::vector<std::string>>(&files));
+
+  // initialize positional options
+  boost::program_options::positional_options_description positional_options;
+  // add input and output files to the positional options
+  positional_options.add("files", -1);
+
+  // initialize options
+  boost::program_options::options_description cmdline_options;
+  // add the options menu and the hidden options to the available options
+  cmdline_options.add(general_options).add(hidden_options);
+
+  // initialize the variables map
+  boost::program_options::variables_map vm;
+
+  try {
+    // parse the options given in input, and check them against positional and
+    // cmdline options: store the result in vm
+    boost::program_options::store(
+        boost::program_options::command_line_parser(argc, argv)
+            .positional(positional_options)
+            .options(cmdline_options)
+            .run(),
+        vm);
+
+    boost::program_options::notify(vm);
+  } catch (const std::exception& e) {
+    // error while parsing the options given in input
+    std::cerr << "Error: " << e.what() << "." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    // help option specified
+    std::cerr << general_options << std::endl;
+
+    return 1;
+  }
+
+  const bool container = vm["container"].as<bool>();
+
+  if (files.size() < 2 || (files.size() > 2 && !container)) {
+    // wrong number of input or output files
+    std::cerr << "Error: Wrong number of input or output files." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  try {
+    if (container) {
+      const auto output = files.back();
+      files.pop_back();
+
+      write_container(output, files);
+    } else {
+      RBGraph g;
+
+      read_graph(files[0], g);
+      write_graph(files[1], g, !vm["text"].as<bool>());
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "." << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
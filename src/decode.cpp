@@ -0,0 +1,215 @@
+#include <boost/program_options.hpp>
+#include <iomanip>
+#include <iostream>
+#include "trace.hpp"
+
+/**
+  @brief Return \e s as a JSON string
+
+  @param[in] s String
+
+  @return JSON string
+*/
+static std::string json_string(const std::string& s) {
+  std::string out = "\"";
+
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+
+  return out + "\"";
+}
+
+/**
+  @brief Write \e events to \e os, one event on each line, indented by the
+         depth of the recursion
+
+  @param[in]     events Events
+  @param[in]     names  Names of the runs
+  @param[in,out] os     Output stream
+*/
+static void print_events(const std::vector<trace::Event>& events,
+                         const std::vector<std::string>& names,
+                         std::ostream& os) {
+  for (const auto& event : events) {
+    os << std::setw(12) << event.ns << " " << std::setw(4) << event.run
+       << " " << std::setw(3) << event.thread << " "
+       << std::string(2 * event.depth, ' ') << trace::type_name(event.type);
+
+    switch (event.type) {
+      case trace::Type::run_begin:
+        os << " " << names[event.run];
+        break;
+      case trace::Type::run_end:
+        os << (event.b ? " Ok" : " No");
+        break;
+      case trace::Type::realize:
+        os << " c" << event.a << (event.b & 1 ? "-" : "+")
+           << (event.b & 2 ? "" : " (not feasible)");
+        break;
+      default:
+        os << " " << event.a << " " << event.b;
+        break;
+    }
+
+    os << std::endl;
+  }
+}
+
+/**
+  @brief Write \e events to \e os in the Chrome trace event format
+
+  Each run is a process and each thread of a run is a thread: the runs and
+  the levels of the recursion are durations, the other events are instants.
+
+  @param[in]     events Events
+  @param[in]     names  Names of the runs
+  @param[in,out] os     Output stream
+*/
+static void print_chrome(const std::vector<trace::Event>& events,
+                         const std::vector<std::string>& names,
+                         std::ostream& os) {
+  os << "{\"traceEvents\": [";
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    const char* phase = "i";
+    std::string name = trace::type_name(event.type);
+
+    switch (event.type) {
+      case trace::Type::run_begin:
+        phase = "B";
+        name = names[event.run];
+        break;
+      case trace::Type::run_end:
+        phase = "E";
+        name = names[event.run];
+        break;
+      case trace::Type::reduce_begin:
+        phase = "B";
+        name = "reduce";
+        break;
+      case trace::Type::reduce_end:
+        phase = "E";
+        name = "reduce";
+        break;
+      default:
+        break;
+    }
+
+    os << (i > 0 ? "," : "") << std::endl
+       << "  {\"name\": " << json_string(name) << ", \"ph\": \"" << phase
+       << "\", \"ts\": " << event.ns / 1000 << "." << std::setw(3)
+       << std::setfill('0') << event.ns % 1000 << std::setfill(' ')
+       << ", \"pid\": " << event.run << ", \"tid\": " << event.thread;
+
+    if (*phase == 'i') os << ", \"s\": \"t\"";
+
+    os << ", \"args\": {\"a\": " << event.a << ", \"b\": " << event.b
+       << ", \"depth\": " << unsigned(event.depth) << "}}";
+  }
+
+  os << std::endl << "]}" << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+  // declare the input file
+  std::string file;
+
+  // initialize options menu
+  boost::program_options::options_description general_options(
+      "Usage: ppp-decode [OPTION...] FILE"
+      "\n"
+      "Decode the binary trace in FILE, written by ppp --trace, and write its "
+      "events, one on each line."
+      "\n\n"
+      "Options");
+
+  general_options.add_options()
+      // option: help message
+      ("help,h", "Display this message.\n")
+      // option: chrome, Chrome trace event format
+      ("chrome,c",
+       boost::program_options::bool_switch()->default_value(false),
+       "Write the events in the Chrome trace event format (JSON), to be "
+       "opened with chrome://tracing or Perfetto.\n");
+
+  // initialize hidden options (not shown in --help)
+  boost::program_options::options_description hidden_options;
+  // option: input file
+  hidden_options.add_options()(
+      "file", boost::program_options::value<std::string>(&file));
+
+  // initialize positional options
+  boost::program_options::positional_options_description positional_options;
+  // add input file to the positional options
+  positional_options.add("file", 1);
+
+  // initialize options
+  boost::program_options::options_description cmdline_options;
+  // add the options menu and the hidden options to the available options
+  cmdline_options.add(general_options).add(hidden_options);
+
+  // initialize the variables map
+  boost::program_options::variables_map vm;
+
+  try {
+    // parse the options given in input, and check them against positional and
+    // cmdline options: store the result in vm
+    boost::program_options::store(
+        boost::program_options::command_line_parser(argc, argv)
+            .positional(positional_options)
+            .options(cmdline_options)
+            .run(),
+        vm);
+
+    boost::program_options::notify(vm);
+  } catch (const std::exception& e) {
+    // error while parsing the options given in input
+    std::cerr << "Error: " << e.what() << "." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    // help
+    std::cout << general_options << std::endl;
+
+    return 0;
+  }
+
+  if (file.empty()) {
+    // input file not specified
+    std::cerr << "Error: No input file specified." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  std::vector<trace::Event> events;
+  std::vector<std::string> names;
+
+  try {
+    trace::read_trace(file, events, names);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << file << ": " << e.what() << "." << std::endl;
+
+    return 1;
+  }
+
+  // runs whose run_begin event is missing have no name
+  for (const auto& event : events) {
+    if (names.size() <= event.run) names.resize(event.run + 1);
+  }
+
+  if (vm["chrome"].as<bool>())
+    print_chrome(events, names, std::cout);
+  else
+    print_events(events, names, std::cout);
+
+  return 0;
+}
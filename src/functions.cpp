@@ -1,12 +1,27 @@
 #include "functions.hpp"
-#include <boost/graph/connected_components.hpp>
-#include <boost/graph/depth_first_search.hpp>
+#include <boost/functional/hash.hpp>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include "stats.hpp"
+#include "taskpool.hpp"
+#include "trace.hpp"
 
 //=============================================================================
 // Auxiliary structs and classes
 
 initial_state_visitor::initial_state_visitor()
-    : m_safe_sources{}, m_sources{}, chain{}, source_v{}, last_v{} {}
+    : m_safe_sources{},
+      m_sources{},
+      chain{},
+      source_v{},
+      last_v{},
+      m_stopped{} {}
 
 initial_state_visitor::initial_state_visitor(std::list<HDVertex>& safe_sources,
                                              std::list<HDVertex>& sources)
@@ -14,7 +29,8 @@ initial_state_visitor::initial_state_visitor(std::list<HDVertex>& safe_sources,
       m_sources{&sources},
       chain{},
       source_v{},
-      last_v{} {
+      last_v{},
+      m_stopped{} {
   m_safe_sources->clear();
   m_sources->clear();
 }
@@ -24,15 +40,15 @@ void initial_state_visitor::initialize_vertex(const HDVertex v,
 
 void initial_state_visitor::start_vertex(const HDVertex v,
                                          const HDGraph& hasse) {
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "DFS: start_vertex: [ ";
+  if (LOGGING(trace)) {
+    // tracing enabled
+    *logging::stream << "DFS: start_vertex: [ ";
 
     for (const auto& kk : hasse[v].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   source_v = v;
@@ -42,15 +58,15 @@ void initial_state_visitor::start_vertex(const HDVertex v,
 
 void initial_state_visitor::discover_vertex(const HDVertex v,
                                             const HDGraph& hasse) {
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "DFS: discover_vertex: [ ";
+  if (LOGGING(trace)) {
+    // tracing enabled
+    *logging::stream << "DFS: discover_vertex: [ ";
 
     for (const auto& kk : hasse[v].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   last_v = v;
@@ -60,30 +76,31 @@ void initial_state_visitor::examine_edge(const HDEdge e, const HDGraph& hasse) {
   HDVertex vs, vt;
   std::tie(vs, vt) = incident(e, hasse);
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "DFS: examine_edge: [ ";
+  if (LOGGING(trace)) {
+    // tracing enabled
+    *logging::stream << "DFS: examine_edge: [ ";
 
     for (const auto& kk : hasse[vs].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "] -";
+    *logging::stream << "] -";
 
     auto jj = hasse[e].signedcharacters.cbegin();
     for (; jj != hasse[e].signedcharacters.cend(); ++jj) {
-      std::cout << *jj;
+      *logging::stream << *jj;
 
-      if (std::next(jj) != hasse[e].signedcharacters.cend()) std::cout << ",";
+      if (std::next(jj) != hasse[e].signedcharacters.cend())
+        *logging::stream << ",";
     }
 
-    std::cout << "-> [ ";
+    *logging::stream << "-> [ ";
 
     for (const auto& kk : hasse[vt].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   // add edge to the chain
@@ -92,33 +109,34 @@ void initial_state_visitor::examine_edge(const HDEdge e, const HDGraph& hasse) {
 
 void initial_state_visitor::tree_edge(const HDEdge e,
                                       const HDGraph& hasse) const {
-  if (logging::enabled) {
-    // verbosity enabled
+  if (LOGGING(trace)) {
+    // tracing enabled
     HDVertex vs, vt;
     std::tie(vs, vt) = incident(e, hasse);
 
-    std::cout << "DFS: tree_edge: [ ";
+    *logging::stream << "DFS: tree_edge: [ ";
 
     for (const auto& kk : hasse[vs].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "] -";
+    *logging::stream << "] -";
 
     auto jj = hasse[e].signedcharacters.cbegin();
     for (; jj != hasse[e].signedcharacters.cend(); ++jj) {
-      std::cout << *jj;
+      *logging::stream << *jj;
 
-      if (std::next(jj) != hasse[e].signedcharacters.cend()) std::cout << ",";
+      if (std::next(jj) != hasse[e].signedcharacters.cend())
+        *logging::stream << ",";
     }
 
-    std::cout << "-> [ ";
+    *logging::stream << "-> [ ";
 
     for (const auto& kk : hasse[vt].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   // ignore
@@ -126,33 +144,34 @@ void initial_state_visitor::tree_edge(const HDEdge e,
 
 void initial_state_visitor::back_edge(const HDEdge e,
                                       const HDGraph& hasse) const {
-  if (logging::enabled) {
-    // verbosity enabled
+  if (LOGGING(trace)) {
+    // tracing enabled
     HDVertex vs, vt;
     std::tie(vs, vt) = incident(e, hasse);
 
-    std::cout << "DFS: back_edge: [ ";
+    *logging::stream << "DFS: back_edge: [ ";
 
     for (const auto& kk : hasse[vs].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "] -";
+    *logging::stream << "] -";
 
     auto jj = hasse[e].signedcharacters.cbegin();
     for (; jj != hasse[e].signedcharacters.cend(); ++jj) {
-      std::cout << *jj;
+      *logging::stream << *jj;
 
-      if (std::next(jj) != hasse[e].signedcharacters.cend()) std::cout << ",";
+      if (std::next(jj) != hasse[e].signedcharacters.cend())
+        *logging::stream << ",";
     }
 
-    std::cout << "-> [ ";
+    *logging::stream << "-> [ ";
 
     for (const auto& kk : hasse[vt].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   // ignore
@@ -163,30 +182,31 @@ void initial_state_visitor::forward_or_cross_edge(const HDEdge e,
   HDVertex vs, vt;
   std::tie(vs, vt) = incident(e, hasse);
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "DFS: forward_or_cross_edge: [ ";
+  if (LOGGING(trace)) {
+    // tracing enabled
+    *logging::stream << "DFS: forward_or_cross_edge: [ ";
 
     for (const auto& kk : hasse[vs].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "] -";
+    *logging::stream << "] -";
 
     auto jj = hasse[e].signedcharacters.cbegin();
     for (; jj != hasse[e].signedcharacters.cend(); ++jj) {
-      std::cout << *jj;
+      *logging::stream << *jj;
 
-      if (std::next(jj) != hasse[e].signedcharacters.cend()) std::cout << ",";
+      if (std::next(jj) != hasse[e].signedcharacters.cend())
+        *logging::stream << ",";
     }
 
-    std::cout << "-> [ ";
+    *logging::stream << "-> [ ";
 
     for (const auto& kk : hasse[vt].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
+    *logging::stream << "]" << std::endl;
   }
 
   if (out_degree(vt, hasse) > 1) {
@@ -216,25 +236,21 @@ void initial_state_visitor::forward_or_cross_edge(const HDEdge e,
 
 void initial_state_visitor::finish_vertex(const HDVertex v,
                                           const HDGraph& hasse) {
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "DFS: finish_vertex: [ ";
+  if (LOGGING(trace)) {
+    // tracing enabled
+    *logging::stream << "DFS: finish_vertex: [ ";
 
     for (const auto& kk : hasse[v].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "]" << std::endl;
-  }
-
-  // build list of vertices in chain
-  std::list<HDVertex> chain_v;
-  for (const auto& e : chain) {
-    chain_v.push_back(source(e, hasse));
+    *logging::stream << "]" << std::endl;
   }
 
-  bool v_in_chain =
-      (std::find(chain_v.cbegin(), chain_v.cend(), v) != chain_v.cend());
+  // check if v is the source of an edge in chain
+  const bool v_in_chain =
+      std::any_of(chain.cbegin(), chain.cend(),
+                  [&](const HDEdge& e) { return source(e, hasse) == v; });
 
   if (out_degree(v, hasse) > 0 || v_in_chain || last_v != v) {
     // v is not the last vertex in the chain
@@ -257,12 +273,13 @@ void initial_state_visitor::perform_test(const HDVertex v,
   // check if source_v is already in m_safe_sources or m_sources
   if ((!m_safe_sources->empty() && source_v == m_safe_sources->back()) ||
       (!m_sources->empty() && source_v == m_sources->back())) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << std::endl
-                << "Chain detected, but its Source has already been processed"
-                << std::endl
-                << std::endl;
+      *logging::stream << std::endl
+                       << "Chain detected, "
+                       << "but its Source has already been processed"
+                       << std::endl
+                       << std::endl;
     }
 
     return;
@@ -278,46 +295,54 @@ void initial_state_visitor::perform_test(const HDVertex v,
     return;
 
   // test is source_v is a safe source (for test 1)
-  if (safe_source_test1(hasse)) {
+  const bool test1 = safe_source_test1(hasse);
+  stats::count(test1 ? stats::Counter::test1_passed
+                     : stats::Counter::test1_failed);
+
+  if (test1) {
     // source_v is a safe source, return (don't add it to m_sources)
     m_safe_sources->push_back(source_v);
 
     if (exponential::enabled || interactive::enabled || nthsource::index > 0) {
       // exponential algorithm or user interaction enabled
       // or safe source selection index is not 0
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << std::endl
-                  << "Source added to the list of safe sources" << std::endl
-                  << std::endl;
+        *logging::stream << std::endl
+                         << "Source added to the list of safe sources"
+                         << std::endl
+                         << std::endl;
       }
 
       return;
     }
 
-    throw InitialState();
+    // source_v is the safe source, stop the visit
+    m_stopped = true;
+
+    return;
   }
 
   // test if the list of safe sources is empty
   if (!m_safe_sources->empty()) {
     // list of safe sources is not empty, return (don't add it to m_sources)
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << std::endl
-                << "Test 2 and 3 wouldn't be feasible: "
-                << "the list of safe sources is not empty" << std::endl
-                << std::endl;
+      *logging::stream << std::endl
+                       << "Test 2 and 3 wouldn't be feasible: "
+                       << "the list of safe sources is not empty" << std::endl
+                       << std::endl;
     }
 
     return;
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl
-              << "Source added to the list of sources" << std::endl;
+    *logging::stream << std::endl
+                     << "Source added to the list of sources" << std::endl;
 
-    if (!chain.empty()) std::cout << std::endl;
+    if (!chain.empty()) *logging::stream << std::endl;
   }
 
   m_sources->push_back(source_v);
@@ -328,17 +353,21 @@ bool initial_state_visitor::safe_chain(const HDVertex v, const HDGraph& hasse) {
     // uninitialized graph properties
     return false;
 
-  const auto& gm = *orig_gm(hasse);
+  auto& gm = *orig_gm(hasse);
+
+  stats::count(stats::Counter::chains);
 
   // chain holds the list of edges representing the chain
 
   // test if the chain is empty
   if (chain.empty()) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << std::endl << "Empty chain" << std::endl << std::endl;
+      *logging::stream << std::endl << "Empty chain" << std::endl << std::endl;
     }
 
+    trace::record(trace::Type::chain, 0, true);
+
     return true;
   }
 
@@ -368,62 +397,72 @@ bool initial_state_visitor::safe_chain(const HDVertex v, const HDGraph& hasse) {
     }
   }
 
-  std::list<SignedCharacter> rsc;
+  arena::List<SignedCharacter> rsc;
   for(const auto sc : lsc) {
-    if(is_active(get_vertex(sc.character,gm), gm))
+    if(is_active(get_vertex(sc.character, Type::character, gm), gm))
       rsc.push_back(sc);
   }
   for(const auto sc : rsc)
     lsc.remove(sc);
 
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl << "Test chain: < ";
+    *logging::stream << std::endl << "Test chain: < ";
 
     for (const auto& kk : lsc) {
-      std::cout << kk << " ";
+      *logging::stream << kk << " ";
     }
 
-    std::cout << "> on a copy of graph Gm" << std::endl;
+    *logging::stream << "> on a copy of graph Gm" << std::endl;
   }
 
-  // copy gm to gm_test
-  RBGraph gm_test;
-  copy_graph(gm, gm_test);
+  // test lsc on gm, the realization is rolled back afterwards
+  const auto gm_checkpoint = checkpoint(gm);
 
   // test if lsc is a safe chain
   bool feasible;
-  std::tie(std::ignore, feasible) = realize(lsc, gm_test);
+  std::tie(std::ignore, feasible) = realize(lsc, gm);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl
-              << "Gm (copy) after the realization of the chain" << std::endl
-              << "Adjacency lists:" << std::endl
-              << gm_test << std::endl
-              << std::endl;
+    *logging::stream << std::endl
+                     << "Gm (copy) after the realization of the chain"
+                     << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << gm << std::endl
+                     << std::endl;
   }
 
   if (!feasible) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Realization not feasible for Gm (copy)" << std::endl
-                << std::endl;
+      *logging::stream << "Realization not feasible for Gm (copy)" << std::endl
+                       << std::endl;
     }
 
+    rollback(gm_checkpoint, gm);
+
+    trace::record(trace::Type::chain, chain.size(), false);
+
     return false;
   }
 
   // if the realization didn't induce a red Σ-graph, chain is a safe chain
-  const auto output = !has_red_sigmagraph(gm_test);
+  const auto output = !has_red_sigmagraph(gm);
+
+  rollback(gm_checkpoint, gm);
+
+  trace::record(trace::Type::chain, chain.size(), output);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
     if (output)
-      std::cout << "No red Σ-graph in Gm (copy)" << std::endl << std::endl;
+      *logging::stream << "No red Σ-graph in Gm (copy)"
+                       << std::endl << std::endl;
     else
-      std::cout << "Found red Σ-graph in Gm (copy)" << std::endl << std::endl;
+      *logging::stream << "Found red Σ-graph in Gm (copy)"
+                       << std::endl << std::endl;
   }
 
   return output;
@@ -436,15 +475,15 @@ bool initial_state_visitor::safe_source_test1(const HDGraph& hasse) {
 
   const auto& gm = *orig_gm(hasse);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl << "Safe sources - test 1" << std::endl;
+    *logging::stream << std::endl << "Safe sources - test 1" << std::endl;
   }
 
   // search for a species s+ in GRB|CM∪A that consists of C(s) and is connected
   // to only inactive characters
-  for (const auto& species_name : hasse[source_v].species) {
-    const auto source_s = get_vertex(species_name, gm);
+  for (const auto& species_id : hasse[source_v].species) {
+    const auto source_s = get_vertex(species_id, Type::species, gm);
     // for each source species (s+) in source_v
     bool active = false;
 
@@ -465,17 +504,19 @@ bool initial_state_visitor::safe_source_test1(const HDGraph& hasse) {
       // s+ is connected to active characters
       continue;
 
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Source species: " << species_name << std::endl;
+      *logging::stream << "Source species: "
+                       << get_name(species_id, Type::species)
+                       << std::endl;
     }
 
     return true;
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "Safe sources - test 1 failed" << std::endl;
+    *logging::stream << "Safe sources - test 1 failed" << std::endl;
   }
 
   return false;
@@ -484,12 +525,101 @@ bool initial_state_visitor::safe_source_test1(const HDGraph& hasse) {
 //=============================================================================
 // Algorithm functions
 
+/**
+  @brief Visit \e hasse in depth-first order, until \e vis is stopped
+
+  The event points of \e vis are invoked in the same order as
+  boost::depth_first_search: the visit is iterative, with a stack holding
+  the out-edges left to examine for each vertex in the current path, and it
+  ends as soon as \e vis is stopped by forward_or_cross_edge or
+  finish_vertex.
+
+  @param[in]     hasse Hasse diagram graph
+  @param[in,out] vis   DFS Visitor
+*/
+static void depth_first_visit(const HDGraph& hasse,
+                              initial_state_visitor& vis) {
+  // index of each vertex in color
+  HDVertexIMap i_map;
+  for (const auto v : boost::make_iterator_range(vertices(hasse)))
+    i_map.emplace(v, i_map.size());
+
+  std::vector<boost::default_color_type> color(num_vertices(hasse),
+                                               boost::white_color);
+
+  for (const auto v : boost::make_iterator_range(vertices(hasse)))
+    vis.initialize_vertex(v, hasse);
+
+  // vertices in the current path, with their out-edges left to examine
+  std::vector<std::tuple<HDVertex, HDOutEdgeIter, HDOutEdgeIter>> stack;
+
+  for (const auto v : boost::make_iterator_range(vertices(hasse))) {
+    // for each vertex not visited yet
+    if (color[i_map.at(v)] != boost::white_color) continue;
+
+    vis.start_vertex(v, hasse);
+
+    color[i_map.at(v)] = boost::gray_color;
+    vis.discover_vertex(v, hasse);
+
+    HDOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(v, hasse);
+    stack.emplace_back(v, e, e_end);
+
+    while (!stack.empty()) {
+      auto u = std::get<0>(stack.back());
+      std::tie(std::ignore, e, e_end) = stack.back();
+      stack.pop_back();
+
+      while (e != e_end) {
+        // for each out-edge of u left to examine
+        const auto vt = target(*e, hasse);
+        vis.examine_edge(*e, hasse);
+
+        const auto vt_color = color[i_map.at(vt)];
+
+        if (vt_color == boost::white_color) {
+          // descend into vt, u is resumed from the next out-edge
+          vis.tree_edge(*e, hasse);
+          stack.emplace_back(u, std::next(e), e_end);
+
+          u = vt;
+          color[i_map.at(u)] = boost::gray_color;
+          vis.discover_vertex(u, hasse);
+
+          std::tie(e, e_end) = out_edges(u, hasse);
+
+          continue;
+        }
+
+        if (vt_color == boost::gray_color) {
+          vis.back_edge(*e, hasse);
+        } else {
+          vis.forward_or_cross_edge(*e, hasse);
+
+          if (vis.stopped()) return;
+        }
+
+        ++e;
+      }
+
+      color[i_map.at(u)] = boost::black_color;
+      vis.finish_vertex(u, hasse);
+
+      if (vis.stopped()) return;
+    }
+  }
+}
+
 std::list<HDVertex> initial_states(const HDGraph& hasse) {
+  const stats::Timer timer(stats::Stage::initial_states);
+
   std::list<HDVertex> output;
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "DFS visit on the Hasse diagram:" << std::endl << std::endl;
+    *logging::stream << "DFS visit on the Hasse diagram:"
+                     << std::endl << std::endl;
   }
 
   // the visitor continuosly modifies the sources variable (passed as reference)
@@ -498,32 +628,13 @@ std::list<HDVertex> initial_states(const HDGraph& hasse) {
   std::list<HDVertex> sources;
   initial_state_visitor vis(output, sources);
 
-  std::map<HDVertex, size_t> i_map;
-  for(auto v : boost::make_iterator_range(vertices(hasse)))
-    i_map.emplace(v, i_map.size());
-  
-  
-  auto ipmap = boost::make_assoc_property_map(i_map);
-  
-  std::vector<boost::default_color_type> c_map(num_vertices(hasse));
-  auto cpmap = boost::make_iterator_property_map(c_map.begin(), ipmap);
-
-  
-  
-
-  try {
-    depth_first_search(hasse, 
-                      boost::visitor(vis)
-                      .vertex_index_map(ipmap)
-                      .color_map(cpmap));
-  } catch (const InitialState& e) {
-  }
+  depth_first_visit(hasse, vis);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl
-              << "DFS visit on the Hasse diagram terminated" << std::endl
-              << std::endl;
+    *logging::stream << std::endl
+                     << "DFS visit on the Hasse diagram terminated" << std::endl
+                     << std::endl;
   }
 
   if (output.empty() && sources.size() == 1) {
@@ -531,60 +642,113 @@ std::list<HDVertex> initial_states(const HDGraph& hasse) {
 
     if (realize_source(source, hasse)) output.push_back(sources.front());
   } else if (output.empty() && sources.size() > 1) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Sources: < ";
+      *logging::stream << "Sources: < ";
 
       for (const auto& i : sources) {
-        std::cout << "[ ";
+        *logging::stream << "[ ";
 
         for (const auto& kk : hasse[i].species) {
-          std::cout << kk << " ";
+          *logging::stream << get_name(kk, Type::species) << " ";
         }
 
-        std::cout << "( ";
+        *logging::stream << "( ";
 
         for (const auto& kk : hasse[i].characters) {
-          std::cout << kk << " ";
+          *logging::stream << get_name(kk, Type::character) << " ";
         }
 
-        std::cout << ") ] ";
+        *logging::stream << ") ] ";
       }
 
-      std::cout << ">" << std::endl << std::endl;
+      *logging::stream << ">" << std::endl << std::endl;
     }
 
     output = safe_source_test2(sources, hasse);
+    stats::count(output.empty() ? stats::Counter::test2_failed
+                                : stats::Counter::test2_passed);
 
-    if (output.empty()) output = safe_source_test3(sources, hasse);
+    if (output.empty()) {
+      output = safe_source_test3(sources, hasse);
+      stats::count(output.empty() ? stats::Counter::test3_failed
+                                  : stats::Counter::test3_passed);
+    }
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "Safe sources: < ";
+    *logging::stream << "Safe sources: < ";
 
     for (const auto& i : output) {
-      std::cout << "[ ";
+      *logging::stream << "[ ";
 
       for (const auto& kk : hasse[i].species) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::species) << " ";
       }
 
-      std::cout << "( ";
+      *logging::stream << "( ";
 
       for (const auto& kk : hasse[i].characters) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::character) << " ";
       }
 
-      std::cout << ") ] ";
+      *logging::stream << ") ] ";
     }
 
-    std::cout << ">" << std::endl << std::endl;
+    *logging::stream << ">" << std::endl << std::endl;
   }
 
   return output;
 }
 
+std::list<HDVertex> safe_sources(const RBGraph& g, RBGraph& gm,
+                                 HDGraph& p) {
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << std::endl
+                     << "Subgraph Gm of G induced by the maximal characters Cm"
+                     << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << gm << std::endl
+                     << std::endl;
+  }
+
+  if (LOGGING(verbose)) {
+    auto ac = active_characters(gm);
+    if(ac.size() <= 0)
+      *logging::stream << "No active characters"
+                       << std::endl;
+    else { 
+      // print the names in alphabetical order
+      std::set<std::string> ac_names;
+      for(const auto elem : ac)
+        ac_names.insert(get_name(elem, Type::character));
+      *logging::stream << "Active characters: ";
+      for(const auto& elem : ac_names)
+        *logging::stream << elem << " ";
+      *logging::stream << std::endl;
+    }
+  } 
+  
+
+  // p = Hasse diagram for gm (Grb|Cm∪A)
+  hasse_diagram(p, g, gm);
+
+  trace::record(trace::Type::hasse, num_vertices(p), num_edges(p));
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "Hasse diagram for the subgraph Gm" << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << p << std::endl
+                     << std::endl;
+  }
+
+  // initial states of p
+  return initial_states(p);
+}
+
 std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
                                       const HDGraph& hasse) {
   std::list<HDVertex> output;
@@ -596,19 +760,19 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
   // const RBGraph& g = *orig_g(hasse);
   const RBGraph& gm = *orig_gm(hasse);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl << "Safe sources - test 2" << std::endl;
+    *logging::stream << std::endl << "Safe sources - test 2" << std::endl;
   }
 
   // list of characters of GRB|CM∪A
-  std::list<std::string> gm_c;
+  std::list<size_t> gm_c;
   RBVertexIter v, v_end;
   std::tie(v, v_end) = vertices(gm);
   for (; v != v_end; ++v) {
     if (!is_character(*v, gm)) continue;
 
-    gm_c.push_back(gm[*v].name);
+    gm_c.push_back(gm[*v].id);
   }
 
   for (const auto& source : sources) {
@@ -623,13 +787,13 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
 
       // if s+ is in source it means that it was already tested in Test 1
       const auto search = std::find(hasse[source].species.cbegin(),
-                                    hasse[source].species.cend(), gm[*v].name);
+                                    hasse[source].species.cend(), gm[*v].id);
 
       if (search != hasse[source].species.cend())
         // s+ is in source, search for another species
         continue;
 
-      std::list<std::string> maximal_c;
+      std::list<size_t> maximal_c;
       size_t count_maximal = 0;
       bool active = false;
 
@@ -647,17 +811,17 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
 
           // search if vt is a maximal character in source_c
           auto search =
-              std::find(source_c.cbegin(), source_c.cend(), gm[vt].name);
+              std::find(source_c.cbegin(), source_c.cend(), gm[vt].id);
 
           if (search == source_c.cend()) {
             // vt is not a maximal character in source_c
 
             // search if vt is a maximal character in GRB|CM∪A
-            search = std::find(gm_c.cbegin(), gm_c.cend(), gm[vt].name);
+            search = std::find(gm_c.cbegin(), gm_c.cend(), gm[vt].id);
 
             if (search != gm_c.cend())
               // add vt to the set of maximal characters
-              maximal_c.push_back(gm[vt].name);
+              maximal_c.push_back(gm[vt].id);
           } else {
             count_maximal++;
           }
@@ -672,10 +836,10 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
         // s+ doesn't have a set of other maximal characters
         continue;
 
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << "Source species (+ other maximal characters): "
-                  << gm[*v].name << std::endl;
+        *logging::stream << "Source species (+ other maximal characters): "
+                         << get_name(*v, gm) << std::endl;
       }
 
       output.push_back(source);
@@ -688,11 +852,12 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
     if (exponential::enabled || interactive::enabled || nthsource::index > 0) {
       // exponential algorithm or user interaction enabled
       // or safe source selection index is not 0
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << std::endl
-                  << "Source added to the list of safe sources" << std::endl
-                  << std::endl;
+        *logging::stream << std::endl
+                         << "Source added to the list of safe sources"
+                         << std::endl
+                         << std::endl;
       }
 
       continue;
@@ -701,10 +866,10 @@ std::list<HDVertex> safe_source_test2(const std::list<HDVertex>& sources,
     return output;
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
     if (output.empty())
-      std::cout << "Safe sources - test 2 failed" << std::endl;
+      *logging::stream << "Safe sources - test 2 failed" << std::endl;
   }
 
   return output;
@@ -720,9 +885,9 @@ std::list<HDVertex> safe_source_test3(const std::list<HDVertex>& sources,
 
   const auto& gm = *orig_gm(hasse);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl << "Safe sources - test 3" << std::endl;
+    *logging::stream << std::endl << "Safe sources - test 3" << std::endl;
   }
 
   HDVertexIMap source_map;
@@ -732,8 +897,8 @@ std::list<HDVertex> safe_source_test3(const std::list<HDVertex>& sources,
     bool source_active = true;
 
     // make sure every species s+ is connected to active characters
-    for (const auto& species_name : hasse[source].species) {
-      const auto source_s = get_vertex(species_name, gm);
+    for (const auto& species_id : hasse[source].species) {
+      const auto source_s = get_vertex(species_id, Type::species, gm);
       // for each source species (s+) in source
       size_t active_count = 0;
 
@@ -786,21 +951,21 @@ std::list<HDVertex> safe_source_test3(const std::list<HDVertex>& sources,
   }
 
   for (const auto& source : maybe_output) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Source (+ active characters): [ ";
+      *logging::stream << "Source (+ active characters): [ ";
 
       for (const auto& kk : hasse[source].species) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::species) << " ";
       }
 
-      std::cout << "( ";
+      *logging::stream << "( ";
 
       for (const auto& kk : hasse[source].characters) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::character) << " ";
       }
 
-      std::cout << ") ]" << std::endl;
+      *logging::stream << ") ]" << std::endl;
     }
 
     output.push_back(source);
@@ -808,11 +973,12 @@ std::list<HDVertex> safe_source_test3(const std::list<HDVertex>& sources,
     if (exponential::enabled || interactive::enabled || nthsource::index > 0) {
       // exponential algorithm or user interaction enabled
       // or safe source selection index is not 0
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << std::endl
-                  << "Source added to the list of safe sources" << std::endl
-                  << std::endl;
+        *logging::stream << std::endl
+                         << "Source added to the list of safe sources"
+                         << std::endl
+                         << std::endl;
       }
 
       continue;
@@ -821,10 +987,10 @@ std::list<HDVertex> safe_source_test3(const std::list<HDVertex>& sources,
     return output;
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
     if (output.empty())
-      std::cout << "Safe sources - test 3 failed" << std::endl;
+      *logging::stream << "Safe sources - test 3 failed" << std::endl;
   }
 
   return output;
@@ -835,82 +1001,88 @@ bool realize_source(const HDVertex source, const HDGraph& hasse) {
     // uninitialized graph properties
     return false;
 
-  const auto& gm = *orig_gm(hasse);
+  auto& gm = *orig_gm(hasse);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "Test source realization: [ ";
+    *logging::stream << "Test source realization: [ ";
 
     for (const auto& kk : hasse[source].species) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    std::cout << "( ";
+    *logging::stream << "( ";
 
     for (const auto& kk : hasse[source].characters) {
-      std::cout << kk << " ";
+      *logging::stream << get_name(kk, Type::character) << " ";
     }
 
-    std::cout << ") ] on a copy of graph G" << std::endl;
+    *logging::stream << ") ] on a copy of graph G" << std::endl;
   }
 
-  // copy g to g_test
-  RBGraph gm_test;
-  copy_graph(gm, gm_test);
+  // test the source on gm, the realization is rolled back afterwards
+  const auto gm_checkpoint = checkpoint(gm);
   
-  RBVertex s = get_vertex(hasse[source].species.front(), gm_test);
-  auto acc = comp_active_characters(s, gm_test);
+  RBVertex s =
+      get_vertex(hasse[source].species.front(), Type::species, gm);
+  auto acc = comp_active_characters(s, gm);
 
   for(const auto& elem : hasse[source].species) {
     for(const auto& ac : acc)
-      add_edge(get_vertex(elem, gm_test), get_vertex(ac, gm_test), gm_test);
+      add_edge(get_vertex(elem, Type::species, gm),
+               get_vertex(ac, Type::character, gm), gm);
   }
   
 
   // initialize the list of characters of source
   std::list<SignedCharacter> source_lsc;
   for (const auto& ci : hasse[source].characters) {
-    if(is_inactive(get_vertex(ci, gm_test), gm_test)) 
+    if(is_inactive(get_vertex(ci, Type::character, gm), gm)) 
       source_lsc.push_back({ci, State::gain});
   }
 
   bool feasible;
-  std::tie(std::ignore, feasible) = realize(source_lsc, gm_test);
+  std::tie(std::ignore, feasible) = realize(source_lsc, gm);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << std::endl
-              << "Gm (copy) after the realization of the source" << std::endl
-              << "Adjacency lists:" << std::endl
-              << gm_test << std::endl
-              << std::endl;
+    *logging::stream << std::endl
+                     << "Gm (copy) after the realization of the source"
+                     << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << gm << std::endl
+                     << std::endl;
   }
 
   if (!feasible) {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Realization not feasible for Gm (copy)" << std::endl;
+      *logging::stream << "Realization not feasible for Gm (copy)" << std::endl;
     }
 
+    rollback(gm_checkpoint, gm);
+
     return false;
   }
 
   // if the realization didn't induce a red Σ-graph, source is a safe source
-  const auto output = !has_red_sigmagraph(gm_test);
+  const auto output = !has_red_sigmagraph(gm);
+
+  rollback(gm_checkpoint, gm);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
     if (output)
-      std::cout << "No red Σ-graph in Gm (copy)" << std::endl;
+      *logging::stream << "No red Σ-graph in Gm (copy)" << std::endl;
     else
-      std::cout << "Found red Σ-graph in Gm (copy)" << std::endl;
+      *logging::stream << "Found red Σ-graph in Gm (copy)" << std::endl;
   }
 
   return output;
 }
 
 bool is_partial(const std::list<SignedCharacter>& reduction) {
-  std::list<std::string> gained_c{};
+  std::list<size_t> gained_c{};
 
   for (const auto& sc : reduction) {
     if (sc.state == State::gain) {
@@ -931,315 +1103,542 @@ bool is_partial(const std::list<SignedCharacter>& reduction) {
 }
 
 //=============================================================================
-// Algorithm main functions
-
-std::list<SignedCharacter> reduce(RBGraph& g) {
-  std::list<SignedCharacter> output;
-
-  if (logging::enabled) {
-    // verbosity enabled
-    
-    std::cout << std::endl
-              << "Working on the red-black graph G" << std::endl
-              << "Adjacency lists:" << std::endl
-              << g << std::endl
-              << std::endl;
-  }
-
-  // cleanup graph from dead vertices
-  // TODO: check if this is needed (realize already does this?)
-  remove_singletons(g);
-
-  if (is_empty(g)) {
-    // if graph is empty
-    // return the empty sequence
-    if (logging::enabled) {
-      // verbosity enabled
-      std::cout << "G empty" << std::endl << std::endl;
-    }
+// Reduction memo
+
+/**
+  Canonical form of a red-black graph: its edges, each one packed as
+  (species ID, character ID, color) and sorted, after a word that identifies
+  the representation and the modifiers the reduction depends on
+*/
+typedef std::vector<uint64_t> RBMemoKey;
+
+/**
+  @brief Struct used to hash the canonical form of a red-black graph
+*/
+struct RBMemoKeyHash {
+  size_t operator()(const RBMemoKey& key) const {
+    return boost::hash_range(key.cbegin(), key.cend());
+  }
+};
+
+/**
+  @brief Struct used to represent an entry of the reduction memo
+*/
+struct RBMemoEntry {
+  std::list<SignedCharacter> reduction{};  ///< Reduction of the graph
+  bool reducible{};                        ///< True if the graph is reducible
+  size_t size{};                           ///< Memory used by the entry
+  std::list<const RBMemoKey*>::iterator lru{};  ///< Position in memo_lru
+};
+
+// memo shared by all threads: entries, keys from the most recently used to
+// the least recently used one, and memory used by the entries
+static std::unordered_map<RBMemoKey, RBMemoEntry, RBMemoKeyHash> memo_map;
+static std::list<const RBMemoKey*> memo_lru;
+static size_t memo_size = 0;
+static std::mutex memo_mutex;
+
+/**
+  @brief Pack the edge between the species \e s and the character \e c of
+         color \e color
+
+  @param[in] s     Species ID
+  @param[in] c     Character ID
+  @param[in] color Color
+
+  @return Packed edge
+*/
+static inline uint64_t memo_edge(const size_t s, const size_t c,
+                                 const Color color) {
+  return (uint64_t(s) << 33) | (uint64_t(c) << 1) |
+         (color == Color::red ? 1 : 0);
+}
 
-    // return < >
-    return output;
-  }
+/**
+  @brief Return the canonical form of \e g
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "G not empty" << std::endl;
-  }
+  @param[in] g Red-black graph
 
-  RBGraphVector components;
-  RBVertexIMap i_map, c_map;
-  RBVertexIAssocMap i_assocmap(i_map), c_assocmap(c_map);
+  @return Canonical form of \e g
+*/
+static RBMemoKey memo_key(const RBGraph& g) {
+  RBMemoKey key{active::enabled ? 1u : 0u};
+  key.reserve(num_edges(g) + 1);
 
-  // fill the vertex index map i_assocmap
   RBVertexIter v, v_end;
   std::tie(v, v_end) = vertices(g);
-  for (size_t index = 0; v != v_end; ++v, ++index) {
-    boost::put(i_assocmap, *v, index);
-  }
-
-  // get number of components and the components map
-  const size_t c_count = boost::connected_components(
-      g, c_assocmap, boost::vertex_index_map(i_assocmap));
-
-  // realize free characters in the graph
-  // TODO: check if this is needed (realize already does this?)
-  std::tie(v, v_end) = vertices(g);
   for (; v != v_end; ++v) {
-    // for each vertex
-    if (is_free(*v, g, c_map)) {
-      // if v is free
-      // realize v-
-      // return < v-, reduce(g) >
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << "G free character " << g[*v].name << std::endl;
-      }
-
-      std::list<SignedCharacter> lsc;
-      std::tie(lsc, std::ignore) = realize({g[*v].name, State::lose}, g);
-
-      output.splice(output.cend(), lsc);
-      output.splice(output.cend(), reduce(g));
+    if (!is_species(*v, g)) continue;
+    // for each species, pack its edges
 
-      // return < v-, reduce(g) >
-      return output;
+    RBOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(*v, g);
+    for (; e != e_end; ++e) {
+      key.push_back(memo_edge(g[*v].id, g[target(*e, g)].id, g[*e].color));
     }
   }
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "G no free characters" << std::endl;
-  }
+  std::sort(std::next(key.begin()), key.end());
 
-  // realize universal characters in the graph
-  // TODO: check if this is needed (realize already does this?)
-  std::tie(v, v_end) = vertices(g);
-  for (; v != v_end; ++v) {
-    // for each vertex
-    if (is_universal(*v, g, c_map)) {
-      // if v is universal
-      // realize v+
-      // return < v+, reduce(g) >
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << "G universal character " << g[*v].name << std::endl;
-      }
+  return key;
+}
 
-      std::list<SignedCharacter> lsc;
-      std::tie(lsc, std::ignore) = realize({g[*v].name, State::gain}, g);
+/**
+  @brief Return the canonical form of \e m
 
-      output.splice(output.cend(), lsc);
-      output.splice(output.cend(), reduce(g));
+  @param[in] m Red-black bit-matrix
 
-      // return < v+, reduce(g) >
-      return output;
-    }
-  }
+  @return Canonical form of \e m
+*/
+static RBMemoKey memo_key(const RBMatrix& m) {
+  RBMemoKey key{active::enabled ? 3u : 2u};
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "G no universal characters" << std::endl;
-  }
+  for (auto s = m.species.find_first(); s != Bitset::npos;
+       s = m.species.find_next(s)) {
+    // for each species, pack its edges (already sorted)
+    const Bitset adj = m.black[s] | m.red[s];
 
-  if (c_count > 1) {
-    components = connected_components(g, c_map, c_count);
-    // if graph is not connected
-    // build subgraphs (connected components) g1, g2, etc.
-    // return < reduce(g1), reduce(g2), ... >
-    for (const auto& component : components) {
-      output.splice(output.cend(), reduce(*component.get()));
+    for (auto c = adj.find_first(); c != Bitset::npos; c = adj.find_next(c)) {
+      key.push_back(
+          memo_edge(s, c, m.red[s][c] ? Color::red : Color::black));
     }
-    // return < reduce(g1), reduce(g2), ... >
-    return output;
-  }
-  else if(logging::enabled) {
-    // verbosity enabled
-    std::cout << "G connected" << std::endl;
   }
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << std::endl;
-  }
+  return key;
+}
 
-  // gm = Grb|Cm∪A, maximal reducible graph of g (Grb)
-  const auto gm = maximal_reducible_graph(g, true);
+/**
+  @brief Search the graph whose canonical form is \e key in the memo
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << std::endl
-              << "Subgraph Gm of G induced by the maximal characters Cm"
-              << std::endl
-              << "Adjacency lists:" << std::endl
-              << gm << std::endl
-              << std::endl;
-  }
+  @param[in]  key       Canonical form of the graph
+  @param[out] reduction Reduction of the graph
+  @param[out] reducible True if the graph is reducible
 
-  if(logging::enabled) {
-    auto ac = active_characters(gm);
-    if(ac.size() <= 0)
-      std::cout << "No active characters"
-                << std::endl;
-    else { 
-      std::cout << "Active characters: ";
-      for(std::string elem : ac)
-        std::cout << elem << " ";
-      std::cout << std::endl;
-    }
-  } 
-  
+  @return True if the graph is in the memo
+*/
+static bool memo_find(const RBMemoKey& key,
+                      std::list<SignedCharacter>& reduction, bool& reducible) {
+  std::lock_guard<std::mutex> lock(memo_mutex);
 
-  // p = Hasse diagram for gm (Grb|Cm∪A)
-  HDGraph p;
-  hasse_diagram(p, g, gm, components, c_map);
+  const auto entry = memo_map.find(key);
 
-  if (logging::enabled) {
-    // verbosity enabled
-    std::cout << "Hasse diagram for the subgraph Gm" << std::endl
-              << "Adjacency lists:" << std::endl
-              << p << std::endl
-              << std::endl;
-  }
+  if (entry == memo_map.end()) return false;
 
-  // s = initial states
-  std::list<HDVertex> s = initial_states(p);
+  // the entry is now the most recently used one
+  memo_lru.splice(memo_lru.begin(), memo_lru, entry->second.lru);
 
-  if (s.empty())
-    // p has no safe source
-    throw NoReduction();
+  reduction = entry->second.reduction;
+  reducible = entry->second.reducible;
 
-  HDVertex source = 0;
-  std::list<SignedCharacter> sc;
+  return true;
+}
 
-  // exponential safe source selection
-  if (exponential::enabled) {
-    // exponential algorithm enabled
-    std::list<std::list<SignedCharacter>> sources_output;
+/**
+  @brief Add the graph whose canonical form is \e key to the memo, evicting
+         the least recently used entries when the memo exceeds memo::budget
 
-    for (const auto& source : s) {
-      // for each safe source in s
-      RBGraph g_test;
-      copy_graph(g, g_test);
+  @param[in] key       Canonical form of the graph
+  @param[in] reducible True if the graph is reducible
+  @param[in] reduction Reduction of the graph
+*/
+static void memo_insert(RBMemoKey key, const bool reducible,
+                        const std::list<SignedCharacter>& reduction) {
+  // rough estimate of the memory used by the entry, list and map nodes
+  // included
+  const size_t size = sizeof(uint64_t) * key.size() +
+                      4 * sizeof(void*) * reduction.size() +
+                      sizeof(RBMemoEntry) + sizeof(RBMemoKey) +
+                      8 * sizeof(void*);
 
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << "Current safe source: [ ";
+  if (size > memo::budget) return;
 
-        for (const auto& kk : p[source].species) {
-          std::cout << kk << " ";
-        }
+  std::lock_guard<std::mutex> lock(memo_mutex);
 
-        std::cout << "( ";
+  const auto entry = memo_map.emplace(std::move(key), RBMemoEntry());
 
-        for (const auto& kk : p[source].characters) {
-          std::cout << kk << " ";
-        }
+  // another thread added the same graph
+  if (!entry.second) return;
 
-        std::cout << ") ]" << std::endl << std::endl;
-      }
+  entry.first->second.reduction = reduction;
+  entry.first->second.reducible = reducible;
+  entry.first->second.size = size;
 
-      // realize the characters of the safe source
-      sc.clear();
+  memo_lru.push_front(&entry.first->first);
+  entry.first->second.lru = memo_lru.begin();
+  memo_size += size;
 
-      for (const auto& ci : p[source].characters) {
-        sc.push_back({ci, State::gain});
-      }
+  while (memo_size > memo::budget) {
+    // evict the least recently used entry
+    const auto evicted = memo_map.find(*memo_lru.back());
 
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << "Realize the characters < ";
+    memo_size -= evicted->second.size;
+    memo_lru.pop_back();
+    memo_map.erase(evicted);
+  }
+}
 
-        for (const auto& kk : sc) {
-          std::cout << kk << " ";
-        }
+//=============================================================================
+// Algorithm main functions
 
-        std::cout << "> in G" << std::endl;
-      }
+/**
+  @brief Run \e function on 0, ..., \e n - 1 concurrently on the task pool,
+         with the same outcome of running it sequentially in order
+
+  The logging output of each call is buffered and written in order, and the
+  exception of the first call (in order) that throws is rethrown. A call that
+  returns true stops the run like a call that throws, without an exception:
+  the calls after the one that stops the run are skipped if they haven't
+  started yet, and their logging output is discarded.
+
+  @param[in] n        Number of calls
+  @param[in] function Function called on each index, returns true if the
+                      calls after it must not be run
+  @param[in] local    Predicate on the index, true if the call must be run by
+                      the calling thread (when the task would be too small)
+*/
+template <typename Function, typename Predicate>
+static void run_in_order(const size_t n, Function function, Predicate local) {
+  std::vector<std::stringstream> logs(n);
+  std::vector<std::exception_ptr> errors(n);
+
+  // index of the first call that threw or stopped the run
+  std::atomic<size_t> first_stop{n};
+
+  const auto run = [&](const size_t i) {
+    // a previous call stopped the run, so the sequential run would have
+    // stopped before this one
+    if (first_stop < i) return;
+
+    const auto stream = logging::stream;
+    logging::stream = &logs[i];
+
+    bool stop = false;
+
+    try {
+      stop = function(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+      stop = true;
+    }
 
-      std::tie(sc, std::ignore) = realize(sc, g_test);
+    if (stop) {
+      auto first = first_stop.load();
+      while (i < first && !first_stop.compare_exchange_weak(first, i)) {
+      }
+    }
 
-      try {
-        std::list<SignedCharacter> rest = reduce(g_test);
+    logging::stream = stream;
+  };
 
-        if (logging::enabled) {
-          // verbosity enabled
-          std::cout << "Ok for safe source [ ";
+  auto& pool = task_pool();
+  TaskGroup group;
 
-          for (const auto& kk : p[source].species) {
-            std::cout << kk << " ";
-          }
+  std::list<size_t> local_calls;
+  for (size_t i = 0; i < n; ++i) {
+    if (local(i)) {
+      local_calls.push_back(i);
+      continue;
+    }
 
-          std::cout << "( ";
+    pool.submit([&run, i]() { run(i); }, group);
+  }
 
-          for (const auto& kk : p[source].characters) {
-            std::cout << kk << " ";
-          }
+  for (const auto i : local_calls) {
+    run(i);
+  }
 
-          std::cout << ") ]" << std::endl << std::endl;
-        }
+  pool.wait(group);
 
-        // append the recursive call to the current source's output
-        sc.splice(sc.end(), rest);
-        sources_output.push_back(sc);
-      } catch (const NoReduction& e) {
-        if (logging::enabled) {
-          // verbosity enabled
-          std::cout << "No for safe source [ ";
+  for (size_t i = 0; i < n && i <= first_stop; ++i) {
+    // for each call, in order, until the one that stopped the run
+    *logging::stream << logs[i].str();
 
-          for (const auto& kk : p[source].species) {
-            std::cout << kk << " ";
-          }
+    if (errors[i]) std::rethrow_exception(errors[i]);
+  }
+}
 
-          std::cout << "( ";
+/**
+  @brief Reduce \e g and append its reduction to \e output
 
-          for (const auto& kk : p[source].characters) {
-            std::cout << kk << " ";
-          }
+  @param[in,out] g      Red-black graph (RBGraph or RBMatrix)
+  @param[in,out] output List of signed characters, cleared if \e g can't be
+                        reduced
 
-          std::cout << ") ]" << std::endl << std::endl;
-        }
-      }
-    }
+  @return True if \e g is reducible
+*/
+template <typename Graph>
+static bool reduce_into(Graph& g, std::list<SignedCharacter>& output) {
+  std::list<SignedCharacter> rest;
+  bool reduced = false;
+  std::tie(rest, reduced) = try_reduce(g);
 
-    if (sources_output.empty())
-      // no realization induces a successful reduction
-      throw NoReduction();
+  if (!reduced) {
+    output.clear();
 
-    if (logging::enabled) {
-      // verbosity enabled
-      std::cout << "Reductions: [" << std::endl;
+    return false;
+  }
 
-      for (const auto& lkk : sources_output) {
-        if (is_partial(lkk))
-          std::cout << "  Partial: ";
-        else
-          std::cout << "  Complete: ";
+  output.splice(output.cend(), rest);
 
-        std::cout << "< ";
+  return true;
+}
 
-        for (const auto& kk : lkk) {
-          std::cout << kk << " ";
-        }
+/**
+  @brief Realize the safe source \e source of \e p in \e g, and reduce what
+         is left of \e g
+
+  @param[in]     source Safe source of \e p
+  @param[in]     p      Hasse diagram graph
+  @param[in,out] g      Red-black graph (RBGraph or RBMatrix)
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g.
+          If the reduction was successful then the bool flag will be true.
+          When the flag is false, the returned list is empty
+*/
+template <typename Graph>
+static std::pair<std::list<SignedCharacter>, bool> reduce_source(
+    const HDVertex source, const HDGraph& p, Graph& g) {
+  std::list<SignedCharacter> sc;
 
-        std::cout << ">" << std::endl;
-      }
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "Current safe source: [ ";
 
-      std::cout << "]" << std::endl << std::endl;
+    for (const auto& kk : p[source].species) {
+      *logging::stream << get_name(kk, Type::species) << " ";
     }
 
-    return sources_output.front();
-  }
-  // user-input-driven safe source selection
-  else if (s.size() > 1 && interactive::enabled) {
-    // user interaction enabled
-    size_t choice = 0;
+    *logging::stream << "( ";
 
-    if (!logging::enabled) {
-      std::cout << std::endl << std::endl;
+    for (const auto& kk : p[source].characters) {
+      *logging::stream << get_name(kk, Type::character) << " ";
     }
 
-    std::cout << "========================================"
+    *logging::stream << ") ]" << std::endl << std::endl;
+  }
+
+  // realize the characters of the safe source
+  for (const auto& ci : p[source].characters) {
+    sc.push_back({ci, State::gain});
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "Realize the characters < ";
+
+    for (const auto& kk : sc) {
+      *logging::stream << kk << " ";
+    }
+
+    *logging::stream << "> in G" << std::endl;
+  }
+
+  bool feasible = false;
+
+  {
+    const stats::Timer timer(stats::Stage::realize);
+
+    std::tie(sc, feasible) = realize(sc, g);
+  }
+
+  std::list<SignedCharacter> rest;
+  bool reduced = false;
+
+  // a source that can't be realized can't start a reduction (g may be left
+  // as it was, and reducing it again would never end)
+  if (feasible) std::tie(rest, reduced) = try_reduce(g);
+
+  if (reduced) {
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "Ok for safe source [ ";
+
+      for (const auto& kk : p[source].species) {
+        *logging::stream << get_name(kk, Type::species) << " ";
+      }
+
+      *logging::stream << "( ";
+
+      for (const auto& kk : p[source].characters) {
+        *logging::stream << get_name(kk, Type::character) << " ";
+      }
+
+      *logging::stream << ") ]" << std::endl << std::endl;
+    }
+
+    // append the recursive call to the current source's output
+    sc.splice(sc.end(), rest);
+
+    if (exponential::strategy == exponential::Strategy::count) {
+      // count the successful reduction
+      if (exponential::count) (*exponential::count)++;
+    } else if (exponential::strategy == exponential::Strategy::stream) {
+      // write the successful reduction to the sink
+      *logging::stream << "Reduction: < ";
+
+      for (const auto& kk : sc) {
+        *logging::stream << kk << " ";
+      }
+
+      *logging::stream << ">" << std::endl;
+    }
+
+    return std::make_pair(sc, true);
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "No for safe source [ ";
+
+    for (const auto& kk : p[source].species) {
+      *logging::stream << get_name(kk, Type::species) << " ";
+    }
+
+    *logging::stream << "( ";
+
+    for (const auto& kk : p[source].characters) {
+      *logging::stream << get_name(kk, Type::character) << " ";
+    }
+
+    *logging::stream << ") ]" << std::endl << std::endl;
+  }
+
+  return std::make_pair(std::list<SignedCharacter>(), false);
+}
+
+/**
+  @brief Realize one of the safe sources \e s of \e p in \e g, and reduce
+         what is left of \e g
+
+  The safe source is chosen according to the algorithm modifiers: every safe
+  source is tested when the exponential algorithm is enabled (or the ones up
+  to the first successful one, see exponential::Strategy), otherwise the one
+  selected by the user or by the safe source index is realized.
+
+  @param[in]     s List of safe sources of \e p
+  @param[in]     p Hasse diagram graph
+  @param[in,out] g Red-black graph (RBGraph or RBMatrix)
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g, and bool = True if \e g is reducible.
+          An empty list and bool = False otherwise
+*/
+template <typename Graph>
+std::pair<std::list<SignedCharacter>, bool> reduce_sources(
+    const std::list<HDVertex>& s, const HDGraph& p, Graph& g) {
+  std::list<SignedCharacter> output;
+
+  HDVertex source = 0;
+  std::list<SignedCharacter> sc;
+
+  // exponential safe source selection
+  if (exponential::enabled) {
+    // exponential algorithm enabled
+    std::list<std::list<SignedCharacter>> sources_output;
+
+    // every safe source is tested
+    trace::record(trace::Type::sources, s.size(), s.size());
+
+    // number of successful safe sources
+    size_t n_reduced = 0;
+
+    // keep the successful reduction lsc, return true if the other safe
+    // sources must not be tested
+    const auto keep = [&](std::list<SignedCharacter>& lsc) {
+      n_reduced++;
+
+      // only the strategy all keeps more than one reduction
+      if (exponential::strategy == exponential::Strategy::all ||
+          sources_output.empty())
+        sources_output.push_back(std::move(lsc));
+
+      return exponential::strategy == exponential::Strategy::first;
+    };
+
+    if (parallel::threads < 2) {
+      for (const auto& source : s) {
+        // for each safe source in s, realized on g and then rolled back
+        const auto g_checkpoint = checkpoint(g);
+
+        std::list<SignedCharacter> lsc;
+        bool reduced = false;
+        std::tie(lsc, reduced) = reduce_source(source, p, g);
+
+        // undo the realization of the source
+        rollback(g_checkpoint, g);
+
+        if (reduced && keep(lsc)) break;
+      }
+    } else {
+      // each safe source in s is realized on its own copy of g, as a task of
+      // the pool (nested calls spawn their own tasks)
+      const std::vector<HDVertex> sources(s.cbegin(), s.cend());
+      std::vector<std::pair<std::list<SignedCharacter>, bool>> outputs(
+          sources.size());
+
+      run_in_order(sources.size(),
+                   [&](const size_t i) {
+                     Graph g_test;
+                     copy_graph(g, g_test);
+
+                     outputs[i] = reduce_source(sources[i], p, g_test);
+
+                     return outputs[i].second &&
+                            exponential::strategy ==
+                                exponential::Strategy::first;
+                   },
+                   [](const size_t) { return false; });
+
+      for (auto& output : outputs) {
+        if (output.second && keep(output.first)) break;
+      }
+    }
+
+    if (sources_output.empty())
+      // no realization induces a successful reduction
+      return std::make_pair(std::list<SignedCharacter>(), false);
+
+    if (LOGGING(verbose) &&
+        exponential::strategy == exponential::Strategy::count) {
+      // verbosity enabled
+      *logging::stream << "Successful reductions: " << n_reduced << std::endl
+                       << std::endl;
+    } else if (LOGGING(verbose) &&
+               exponential::strategy != exponential::Strategy::stream) {
+      // verbosity enabled
+      *logging::stream << "Reductions: [" << std::endl;
+
+      for (const auto& lkk : sources_output) {
+        if (is_partial(lkk))
+          *logging::stream << "  Partial: ";
+        else
+          *logging::stream << "  Complete: ";
+
+        *logging::stream << "< ";
+
+        for (const auto& kk : lkk) {
+          *logging::stream << kk << " ";
+        }
+
+        *logging::stream << ">" << std::endl;
+      }
+
+      *logging::stream << "]" << std::endl << std::endl;
+    }
+
+    return std::make_pair(sources_output.front(), true);
+  }
+  // user-input-driven safe source selection
+  else if (s.size() > 1 && interactive::enabled) {
+    // user interaction enabled
+    size_t choice = 0;
+
+    if (!LOGGING(verbose)) {
+      std::cout << std::endl << std::endl;
+    }
+
+    std::cout << "========================================"
               << "========================================" << std::endl
               << std::endl
               << "List of available source indexes to choose from:"
@@ -1250,13 +1649,13 @@ std::list<SignedCharacter> reduce(RBGraph& g) {
       std::cout << "  - " << index << ": [ ";
 
       for (const auto& kk : p[source].species) {
-        std::cout << kk << " ";
+        std::cout << get_name(kk, Type::species) << " ";
       }
 
       std::cout << "( ";
 
       for (const auto& kk : p[source].characters) {
-        std::cout << kk << " ";
+        std::cout << get_name(kk, Type::character) << " ";
       }
 
       std::cout << ") ]" << std::endl;
@@ -1287,13 +1686,13 @@ std::list<SignedCharacter> reduce(RBGraph& g) {
           std::cout << "Source [ ";
 
           for (const auto& kk : p[source].species) {
-            std::cout << kk << " ";
+            std::cout << get_name(kk, Type::species) << " ";
           }
 
           std::cout << "( ";
 
           for (const auto& kk : p[source].characters) {
-            std::cout << kk << " ";
+            std::cout << get_name(kk, Type::character) << " ";
           }
 
           std::cout << ") ] selected" << std::endl << std::endl;
@@ -1316,11 +1715,12 @@ std::list<SignedCharacter> reduce(RBGraph& g) {
       sc.push_back({ci, State::gain});
     }
 
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "========================================"
-                << "========================================" << std::endl
-                << std::endl;
+      *logging::stream << "========================================"
+                       << "========================================"
+                       << std::endl
+                       << std::endl;
     }
   } else if (s.size() > 1 && nthsource::index > 0) {
     if (nthsource::index < s.size())
@@ -1328,21 +1728,21 @@ std::list<SignedCharacter> reduce(RBGraph& g) {
     else
       source = s.back();
 
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Source [ ";
+      *logging::stream << "Source [ ";
 
       for (const auto& kk : p[source].species) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::species) << " ";
       }
 
-      std::cout << "( ";
+      *logging::stream << "( ";
 
       for (const auto& kk : p[source].characters) {
-        std::cout << kk << " ";
+        *logging::stream << get_name(kk, Type::character) << " ";
       }
 
-      std::cout << ") ] selected " << std::endl << std::endl;
+      *logging::stream << ") ] selected " << std::endl << std::endl;
     }
   }
   // standard safe source selection (the first one found)
@@ -1350,146 +1750,631 @@ std::list<SignedCharacter> reduce(RBGraph& g) {
     source = s.front();
   }
 
+  if (trace::current) {
+    const auto index = std::distance(
+        s.cbegin(), std::find(s.cbegin(), s.cend(), source));
+    trace::record(trace::Type::sources, s.size(), index);
+  }
+
   sc.clear();
 
   for (const auto& ci : p[source].characters) {
     sc.push_back({ci, State::gain});
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "Realize the characters < ";
+    *logging::stream << "Realize the characters < ";
 
     for (const auto& kk : sc) {
-      std::cout << kk << " ";
+      *logging::stream << kk << " ";
     }
 
-    std::cout << "> in G" << std::endl;
+    *logging::stream << "> in G" << std::endl;
   }
 
   // realize the characters of the safe source
-  std::tie(sc, std::ignore) = realize(sc, g);
+  bool feasible = false;
+
+  {
+    const stats::Timer timer(stats::Stage::realize);
+
+    std::tie(sc, feasible) = realize(sc, g);
+  }
+
+  if (!feasible)
+    // the safe source can't be realized, see reduce_source
+    return std::make_pair(std::list<SignedCharacter>(), false);
 
   // append the list of realized characters and the recursive call to the
   // output in constant time (std::list::splice simply moves pointers around
   // instead of copying the data)
   output.splice(output.cend(), sc);
-  output.splice(output.cend(), reduce(g));
+  const auto reduced = reduce_into(g, output);
 
   // return < sc, reduce(g) >
+  return std::make_pair(output, reduced);
+}
+
+/**
+  @brief Reduce each graph in \e components, and return the concatenation of
+         their reductions in component order
+
+  Same as calling try_reduce on each component in order, until one of them
+  can't be reduced. When parallel::threads is greater than 1, the components
+  with at least parallel::grain vertices are reduced concurrently by the task
+  pool, while the calling thread reduces the other ones.
+  The logging output of each component is buffered and written in component
+  order, up to the first component that can't be reduced (the components
+  after it are skipped): the output is the same as the one of the sequential
+  reduction.
+
+  @param[in,out] components Connected components (red-black graphs or
+                            bit-matrices)
+
+  @return Reduction (list of signed characters) of the components, and
+          bool = True if every component is reducible.
+          An empty list and bool = False otherwise
+*/
+template <typename Graph>
+static std::pair<std::list<SignedCharacter>, bool> reduce_components(
+    const std::vector<std::unique_ptr<Graph>>& components) {
+  std::list<SignedCharacter> output;
+
+  if (trace::current) {
+    size_t n_vertices = 0;
+    for (const auto& component : components) {
+      n_vertices += num_species(*component) + num_characters(*component);
+    }
+
+    trace::record(trace::Type::components, components.size(), n_vertices);
+  }
+
+  if (parallel::threads < 2 || interactive::enabled) {
+    // sequential reduction (user interaction needs the standard input)
+    for (const auto& component : components) {
+      if (!reduce_into(*component.get(), output))
+        // the component can't be reduced
+        return std::make_pair(std::list<SignedCharacter>(), false);
+    }
+
+    return std::make_pair(output, true);
+  }
+
+  std::vector<std::pair<std::list<SignedCharacter>, bool>> outputs(
+      components.size());
+
+  run_in_order(components.size(),
+               [&](const size_t i) {
+                 outputs[i] = try_reduce(*components[i]);
+
+                 // the components after one that can't be reduced are
+                 // skipped
+                 return !outputs[i].second;
+               },
+               [&](const size_t i) {
+                 // small components are reduced by the calling thread
+                 const auto& component = *components[i];
+
+                 return num_species(component) + num_characters(component) <
+                        parallel::grain;
+               });
+
+  for (auto& component_output : outputs) {
+    if (!component_output.second)
+      // the component can't be reduced
+      return std::make_pair(std::list<SignedCharacter>(), false);
+
+    output.splice(output.cend(), component_output.first);
+  }
+
+  return std::make_pair(output, true);
+}
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of
+         \e g, without looking for it in the memo
+
+  @param[in,out] g Red-black graph
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g, and bool = True if \e g is reducible.
+          An empty list and bool = False otherwise
+*/
+static std::pair<std::list<SignedCharacter>, bool> reduce_graph(RBGraph& g) {
+  std::list<SignedCharacter> output;
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    
+    *logging::stream << std::endl
+                     << "Working on the red-black graph G" << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << g << std::endl
+                     << std::endl;
+  }
+
+  // cleanup graph from dead vertices
+  // TODO: check if this is needed (realize already does this?)
+  remove_singletons(g);
+
+  if (is_empty(g)) {
+    // if graph is empty
+    // return the empty sequence
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "G empty" << std::endl << std::endl;
+    }
+
+    // return < >
+    return std::make_pair(output, true);
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G not empty" << std::endl;
+  }
+
+  RBGraphVector components;
+
+  // get number of components
+  const size_t c_count = num_components(g);
+
+  // realize free characters in the graph
+  // TODO: check if this is needed (realize already does this?)
+  RBVertexIter v, v_end;
+  std::tie(v, v_end) = vertices(g);
+  for (; v != v_end; ++v) {
+    // for each vertex
+    if (is_free(*v, g)) {
+      // if v is free
+      // realize v-
+      // return < v-, reduce(g) >
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G free character " << get_name(*v, g) << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({g[*v].id, State::lose}, g);
+
+      output.splice(output.cend(), lsc);
+      const auto reduced = reduce_into(g, output);
+
+      // return < v-, reduce(g) >
+      return std::make_pair(output, reduced);
+    }
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G no free characters" << std::endl;
+  }
+
+  // realize universal characters in the graph
+  // TODO: check if this is needed (realize already does this?)
+  std::tie(v, v_end) = vertices(g);
+  for (; v != v_end; ++v) {
+    // for each vertex
+    if (is_universal(*v, g)) {
+      // if v is universal
+      // realize v+
+      // return < v+, reduce(g) >
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G universal character " << get_name(*v, g)
+                         << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({g[*v].id, State::gain}, g);
+
+      output.splice(output.cend(), lsc);
+      const auto reduced = reduce_into(g, output);
+
+      // return < v+, reduce(g) >
+      return std::make_pair(output, reduced);
+    }
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G no universal characters" << std::endl;
+  }
+
+  if (c_count > 1) {
+    components = connected_components(g);
+    // if graph is not connected
+    // build subgraphs (connected components) g1, g2, etc.
+    // return < reduce(g1), reduce(g2), ... >
+    // return < reduce(g1), reduce(g2), ... >
+    return reduce_components(components);
+  }
+  else if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G connected" << std::endl;
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << std::endl;
+  }
+
+  // gm = Grb|Cm∪A, maximal reducible graph of g (Grb)
+  auto gm = maximal_reducible_graph(g, true);
+
+  // p = Hasse diagram for gm (Grb|Cm∪A)
+  HDGraph p;
+
+  // s = initial states
+  const auto s = safe_sources(g, gm, p);
+
+  if (s.empty())
+    // p has no safe source
+    return std::make_pair(std::list<SignedCharacter>(), false);
+
+  return reduce_sources(s, p, g);
+}
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of
+         \e m, without looking for it in the memo
+
+  @param[in,out] m Red-black bit-matrix
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e m, and bool = True if \e m is reducible.
+          An empty list and bool = False otherwise
+*/
+static std::pair<std::list<SignedCharacter>, bool> reduce_graph(
+    RBMatrix& m) {
+  std::list<SignedCharacter> output;
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << std::endl
+                     << "Working on the red-black graph G" << std::endl
+                     << "Adjacency lists:" << std::endl
+                     << m << std::endl
+                     << std::endl;
+  }
+
+  // cleanup graph from dead vertices
+  remove_singletons(m);
+
+  if (is_empty(m)) {
+    // if graph is empty
+    // return the empty sequence
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "G empty" << std::endl << std::endl;
+    }
+
+    // return < >
+    return std::make_pair(output, true);
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G not empty" << std::endl;
+  }
+
+  // get number of components and the components map
+  RBMatrixComponents comps;
+  const size_t c_count = connected_components(m, comps);
+
+  // realize free characters in the graph
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    // for each character
+    if (is_free(c, m, comps)) {
+      // if c is free
+      // realize c-
+      // return < c-, reduce(m) >
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G free character "
+                         << get_name(c, Type::character) << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({c, State::lose}, m);
+
+      output.splice(output.cend(), lsc);
+      const auto reduced = reduce_into(m, output);
+
+      // return < c-, reduce(m) >
+      return std::make_pair(output, reduced);
+    }
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G no free characters" << std::endl;
+  }
+
+  // realize universal characters in the graph
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    // for each character
+    if (is_universal(c, m, comps)) {
+      // if c is universal
+      // realize c+
+      // return < c+, reduce(m) >
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G universal character "
+                         << get_name(c, Type::character) << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({c, State::gain}, m);
+
+      output.splice(output.cend(), lsc);
+      const auto reduced = reduce_into(m, output);
+
+      // return < c+, reduce(m) >
+      return std::make_pair(output, reduced);
+    }
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G no universal characters" << std::endl;
+  }
+
+  if (c_count > 1) {
+    // if graph is not connected
+    // build subgraphs (connected components) m1, m2, etc.
+    // return < reduce(m1), reduce(m2), ... >
+    const auto components = connected_components(m, comps, c_count);
+
+    // return < reduce(m1), reduce(m2), ... >
+    return reduce_components(components);
+  } else if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "G connected" << std::endl;
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << std::endl;
+  }
+
+  // the Hasse diagram is built on the equivalent red-black graph
+  RBGraph g;
+  copy_graph(m, g);
+
+  // gm = Grb|Cm∪A, maximal reducible graph of g (Grb)
+  auto gm = maximal_reducible_graph(g, true);
+
+  // p = Hasse diagram for gm (Grb|Cm∪A)
+  HDGraph p;
+
+  // s = initial states
+  const auto s = safe_sources(g, gm, p);
+
+  if (s.empty())
+    // p has no safe source
+    return std::make_pair(std::list<SignedCharacter>(), false);
+
+  return reduce_sources(s, p, m);
+}
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of
+         \e g, taking it from the memo if \e g was already reduced
+
+  The memo is only used by the exponential algorithm, where the same graph
+  is often reached by realizing the safe sources in different orders, and
+  it's not used when logging is enabled, so that every reduction is logged,
+  or by the strategies count and stream, so that every reduction is counted
+  or written.
+
+  @param[in,out] g Red-black graph (RBGraph or RBMatrix)
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g, and bool = True if \e g is reducible.
+          An empty list and bool = False otherwise
+*/
+template <typename Graph>
+static std::pair<std::list<SignedCharacter>, bool> cached_reduce(Graph& g) {
+  if (!exponential::enabled || LOGGING(verbose) || memo::budget == 0 ||
+      exponential::strategy == exponential::Strategy::count ||
+      exponential::strategy == exponential::Strategy::stream)
+    return reduce_graph(g);
+
+  auto key = memo_key(g);
+
+  std::list<SignedCharacter> output;
+  bool reducible = false;
+
+  if (memo_find(key, output, reducible))
+    // g was already reduced
+    return std::make_pair(output, reducible);
+
+  std::tie(output, reducible) = reduce_graph(g);
+
+  memo_insert(std::move(key), reducible, output);
+
+  return std::make_pair(output, reducible);
+}
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of
+         \e g, as cached_reduce, as a level of the reduction recursion
+
+  The level is timed and traced, and its temporaries (e.g. the Hasse diagram)
+  are allocated from an arena that is released when the level ends.
+
+  @param[in,out] g Red-black graph (RBGraph or RBMatrix)
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g, and bool = True if \e g is reducible.
+          An empty list and bool = False otherwise
+*/
+template <typename Graph>
+static std::pair<std::list<SignedCharacter>, bool> memo_reduce(Graph& g) {
+  const stats::Level level;
+  const arena::Scope scope;
+  const stats::Timer timer(stats::Stage::reduce, stats::depth == 1);
+
+  trace::record(trace::Type::reduce_begin, num_species(g), num_characters(g));
+
+  std::list<SignedCharacter> output;
+  bool reducible = false;
+  std::tie(output, reducible) = cached_reduce(g);
+
+  trace::record(trace::Type::reduce_end, reducible, output.size());
+
+  return std::make_pair(output, reducible);
+}
+
+std::list<SignedCharacter> reduce(RBGraph& g) {
+  std::list<SignedCharacter> output;
+  bool reducible = false;
+  std::tie(output, reducible) = memo_reduce(g);
+
+  if (!reducible) throw NoReduction();
+
   return output;
 }
 
+std::list<SignedCharacter> reduce(RBMatrix& m) {
+  std::list<SignedCharacter> output;
+  bool reducible = false;
+  std::tie(output, reducible) = memo_reduce(m);
+
+  if (!reducible) throw NoReduction();
+
+  return output;
+}
+
+std::pair<std::list<SignedCharacter>, bool> try_reduce(RBGraph& g) {
+  return memo_reduce(g);
+}
+
+std::pair<std::list<SignedCharacter>, bool> try_reduce(RBMatrix& m) {
+  return memo_reduce(m);
+}
+
+/**
+  @brief Record the realization of \e sc in the trace of the run, if any
+
+  @param[in] sc       Signed character
+  @param[in] feasible True if the realization of \e sc is feasible
+*/
+static void trace_realize(const SignedCharacter& sc, const bool feasible) {
+  trace::record(trace::Type::realize, sc.character,
+                (sc.state == State::lose ? 1 : 0) + (feasible ? 2 : 0));
+}
+
 std::pair<std::list<SignedCharacter>, bool> realize(const SignedCharacter& sc,
                                                     RBGraph& g) {
+  stats::count(stats::Counter::realize);
+
   std::list<SignedCharacter> output;
 
   // current character vertex
   RBVertex cv = 0;
 
-  // get the vertex in g whose name is sc.character
+  // get the vertex in g whose ID is sc.character
   try {
-    cv = get_vertex(sc.character, g);
+    cv = get_vertex(sc.character, Type::character, g);
   } catch (const std::out_of_range& e) {
-    // g has no vertex named sc.character
+    // g has no character with ID sc.character
+    trace_realize(sc, false);
+
     return std::make_pair(output, false);
   }
 
-  RBVertexIMap i_map, c_map;
-  RBVertexIAssocMap i_assocmap(i_map), c_assocmap(c_map);
-
-  // fill vertex index map
   RBVertexIter v, v_end;
-  std::tie(v, v_end) = vertices(g);
-  for (size_t index = 0; v != v_end; ++v, ++index) {
-    boost::put(i_assocmap, *v, index);
-  }
-
-  // build the components map
-  boost::connected_components(g, c_assocmap,
-                              boost::vertex_index_map(i_assocmap));
 
   if (sc.state == State::gain && is_inactive(cv, g)) {
     // c+ and c is inactive
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Realizing " << sc;
+      *logging::stream << "Realizing " << sc;
+    }
+
+    // collect the species in the same connected component of cv before
+    // changing any edge, the components are updated as edges are removed
+    const auto c = component(cv, g);
+    std::list<RBVertex> species;
+
+    std::tie(v, v_end) = vertices(g);
+    for (; v != v_end; ++v) {
+      if (!is_species(*v, g) || component(*v, g) != c) continue;
+
+      species.push_back(*v);
     }
 
     // realize the character c+:
     // - add a red edge between c and each species in D(c) \ N(c)
     // - delete all black edges incident on c
-    std::tie(v, v_end) = vertices(g);
-    for (; v != v_end; ++v) {
-      if (!is_species(*v, g) || c_map.at(*v) != c_map.at(cv)) continue;
+    for (const auto& s : species) {
       // for each species in the same connected component of cv
 
       RBEdge e;
       bool exists;
-      std::tie(e, exists) = edge(*v, cv, g);
+      std::tie(e, exists) = edge(s, cv, g);
 
       if (exists)
-        // there is an edge (black) between *v and cv
+        // there is an edge (black) between s and cv
         remove_edge(e, g);
       else
-        // there isn't an edge between *v and cv
-        add_edge(*v, cv, Color::red, g);
+        // there isn't an edge between s and cv
+        add_edge(s, cv, Color::red, g);
     }
 
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << std::endl;
+      *logging::stream << std::endl;
     }
   } else if (sc.state == State::lose && is_active(cv, g)) {
     // c- and c is active
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Realizing " << sc << std::endl;
+      *logging::stream << "Realizing " << sc << std::endl;
     }
 
     // realize the character c-:
     // - delete all edges incident on c
     clear_vertex(cv, g);
   } else {
-    if (logging::enabled) {
+    if (LOGGING(verbose)) {
       // verbosity enabled
-      std::cout << "Could not realize " << sc << std::endl;
+      *logging::stream << "Could not realize " << sc << std::endl;
     }
 
+    trace_realize(sc, false);
+
     // this should never happen during the algorithm, but it is handled just in
     // case something breaks (or user input happens)
     return std::make_pair(output, false);
   }
 
+  trace_realize(sc, true);
+
   output.push_back(sc);
 
   // delete all isolated vertices
   remove_singletons(g);
 
-  // fill vertex index map
-  std::tie(v, v_end) = vertices(g);
-  for (size_t index = 0; v != v_end; ++v, ++index) {
-    boost::put(i_assocmap, *v, index);
-  }
-
-  // build the components map
-  boost::connected_components(g, c_assocmap,
-                              boost::vertex_index_map(i_assocmap));
-
   // realize all free characters that came up after realizing sc
   std::tie(v, v_end) = vertices(g);
   for (; v != v_end; ++v) {
     // for each vertex
-    if (is_free(*v, g, c_map)) {
+    if (is_free(*v, g)) {
       // if v is free
       // realize v-
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << "G free character " << g[*v].name << std::endl;
+        *logging::stream << "G free character " << get_name(*v, g) << std::endl;
       }
 
       std::list<SignedCharacter> lsc;
-      std::tie(lsc, std::ignore) = realize({g[*v].name, State::lose}, g);
+      std::tie(lsc, std::ignore) = realize({g[*v].id, State::lose}, g);
 
       output.splice(output.cend(), lsc);
 
@@ -1501,16 +2386,17 @@ std::pair<std::list<SignedCharacter>, bool> realize(const SignedCharacter& sc,
   std::tie(v, v_end) = vertices(g);
   for (; v != v_end; ++v) {
     // for each vertex
-    if (is_universal(*v, g, c_map)) {
+    if (is_universal(*v, g)) {
       // if v is universal
       // realize v+
-      if (logging::enabled) {
+      if (LOGGING(verbose)) {
         // verbosity enabled
-        std::cout << "G universal character " << g[*v].name << std::endl;
+        *logging::stream << "G universal character " << get_name(*v, g)
+                         << std::endl;
       }
 
       std::list<SignedCharacter> lsc;
-      std::tie(lsc, std::ignore) = realize({g[*v].name, State::gain}, g);
+      std::tie(lsc, std::ignore) = realize({g[*v].id, State::gain}, g);
 
       output.splice(output.cend(), lsc);
 
@@ -1533,7 +2419,7 @@ std::pair<std::list<SignedCharacter>, bool> realize(const RBVertex v,
   for (; e != e_end; ++e) {
     const auto u = target(*e, g);
 
-    if (is_inactive(u, g)) lsc.push_back({g[u].name, State::gain});
+    if (is_inactive(u, g)) lsc.push_back({g[u].id, State::gain});
   }
 
   return realize(lsc, g);
@@ -1563,6 +2449,156 @@ std::pair<std::list<SignedCharacter>, bool> realize(
   return std::make_pair(output, true);
 }
 
+std::pair<std::list<SignedCharacter>, bool> realize(const SignedCharacter& sc,
+                                                    RBMatrix& m) {
+  stats::count(stats::Counter::realize);
+
+  std::list<SignedCharacter> output;
+
+  // current character
+  size_t c = 0;
+
+  // get the character in m whose ID is sc.character
+  try {
+    c = get_character(sc.character, m);
+  } catch (const std::out_of_range& e) {
+    // m has no character with ID sc.character
+    trace_realize(sc, false);
+
+    return std::make_pair(output, false);
+  }
+
+  RBMatrixComponents comps;
+  connected_components(m, comps);
+
+  if (sc.state == State::gain && is_inactive(c, m)) {
+    // c+ and c is inactive
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "Realizing " << sc;
+    }
+
+    // realize the character c+:
+    // - add a red edge between c and each species in D(c) \ N(c)
+    // - delete all black edges incident on c
+    for (auto s = m.species.find_first(); s != Bitset::npos;
+         s = m.species.find_next(s)) {
+      if (comps.species[s] != comps.characters[c]) continue;
+      // for each species in the same connected component of c
+
+      if (m.black_t[c][s])
+        // there is an edge (black) between s and c
+        remove_edge(s, c, m);
+      else
+        // there isn't an edge between s and c
+        add_edge(s, c, Color::red, m);
+    }
+
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << std::endl;
+    }
+  } else if (sc.state == State::lose && is_active(c, m)) {
+    // c- and c is active
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "Realizing " << sc << std::endl;
+    }
+
+    // realize the character c-:
+    // - delete all edges incident on c
+    clear_character(c, m);
+  } else {
+    if (LOGGING(verbose)) {
+      // verbosity enabled
+      *logging::stream << "Could not realize " << sc << std::endl;
+    }
+
+    trace_realize(sc, false);
+
+    return std::make_pair(output, false);
+  }
+
+  trace_realize(sc, true);
+
+  output.push_back(sc);
+
+  // delete all isolated vertices
+  remove_singletons(m);
+
+  // build the components map
+  connected_components(m, comps);
+
+  // realize all free characters that came up after realizing sc
+  for (auto u = m.characters.find_first(); u != Bitset::npos;
+       u = m.characters.find_next(u)) {
+    // for each character
+    if (is_free(u, m, comps)) {
+      // if u is free
+      // realize u-
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G free character "
+                         << get_name(u, Type::character) << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({u, State::lose}, m);
+
+      output.splice(output.cend(), lsc);
+
+      return std::make_pair(output, true);
+    }
+  }
+
+  // realize all universal characters that came up after realizing sc
+  for (auto u = m.characters.find_first(); u != Bitset::npos;
+       u = m.characters.find_next(u)) {
+    // for each character
+    if (is_universal(u, m, comps)) {
+      // if u is universal
+      // realize u+
+      if (LOGGING(verbose)) {
+        // verbosity enabled
+        *logging::stream << "G universal character "
+                         << get_name(u, Type::character) << std::endl;
+      }
+
+      std::list<SignedCharacter> lsc;
+      std::tie(lsc, std::ignore) = realize({u, State::gain}, m);
+
+      output.splice(output.cend(), lsc);
+
+      return std::make_pair(output, true);
+    }
+  }
+
+  return std::make_pair(output, true);
+}
+
+std::pair<std::list<SignedCharacter>, bool> realize(
+    const std::list<SignedCharacter>& lsc, RBMatrix& m) {
+  std::list<SignedCharacter> output;
+
+  // realize the list of signed characters lsc; the algorithm stops when a
+  // non-feasible realization is encountered, setting the boolean flag to false
+  for (const auto& i : lsc) {
+    if (std::find(output.cbegin(), output.cend(), i) != output.cend())
+      // the signed character i has already been realized in a previous sc
+      continue;
+
+    std::list<SignedCharacter> sc;
+    bool feasible;
+    std::tie(sc, feasible) = realize(i, m);
+
+    if (!feasible) return std::make_pair(sc, false);
+
+    output.splice(output.cend(), sc);
+  }
+
+  return std::make_pair(output, true);
+}
+
 bool is_complete(std::list<SignedCharacter> sc, const RBGraph& gm){
   RBVertexIter v, v_end;
   auto scb = sc.begin();
@@ -1571,7 +2607,7 @@ bool is_complete(std::list<SignedCharacter> sc, const RBGraph& gm){
   while(v != v_end){
     if(is_inactive(*v, gm)){
       while(scb != sce){
-        if((get_vertex(scb->character, gm) == *v))
+        if((get_vertex(scb->character, Type::character, gm) == *v))
           return false;
         scb++;
       }
@@ -1580,3 +2616,174 @@ bool is_complete(std::list<SignedCharacter> sc, const RBGraph& gm){
   }
   return true;
 }
+
+//=============================================================================
+// Reduction verification
+
+/**
+  @brief Struct used to represent the connected components of a bit-matrix
+         while a reduction is being replayed on it
+*/
+struct RBMatrixCheckComponents {
+  std::vector<size_t> species{};     ///< Component of each species
+  std::vector<size_t> characters{};  ///< Component of each character
+  std::vector<Bitset> comp_species{};     ///< Species of each component
+  std::vector<Bitset> comp_characters{};  ///< Characters of each component
+};
+
+/**
+  @brief Split the component \e i of \e comps into the connected components
+         of \e m it is made of
+
+  The first connected component found keeps the label \e i, the other ones
+  get new labels.
+
+  @param[in]     i     Component label
+  @param[in]     m     Red-black bit-matrix
+  @param[in,out] comps Connected components of \e m
+*/
+static void split_component(const size_t i, const RBMatrix& m,
+                            RBMatrixCheckComponents& comps) {
+  Bitset species = comps.comp_species[i];
+  Bitset characters = comps.comp_characters[i];
+
+  size_t label = i;
+  while (species.any() || characters.any()) {
+    // for each connected component in species and characters
+    Bitset comp_s(species.size()), comp_c(characters.size());
+    Bitset next_s(species.size()), next_c(characters.size());
+
+    if (characters.any())
+      next_c.set(characters.find_first());
+    else
+      next_s.set(species.find_first());
+
+    while (next_s.any() || next_c.any()) {
+      // visit the vertices reached in the last step
+      comp_s |= next_s;
+      comp_c |= next_c;
+
+      Bitset adj_s(species.size()), adj_c(characters.size());
+
+      for (auto c = next_c.find_first(); c != Bitset::npos;
+           c = next_c.find_next(c)) {
+        adj_s |= m.black_t[c];
+        adj_s |= m.red_t[c];
+      }
+
+      for (auto s = next_s.find_first(); s != Bitset::npos;
+           s = next_s.find_next(s)) {
+        adj_c |= m.black[s];
+        adj_c |= m.red[s];
+      }
+
+      next_s = adj_s - comp_s;
+      next_c = adj_c - comp_c;
+    }
+
+    for (auto s = comp_s.find_first(); s != Bitset::npos;
+         s = comp_s.find_next(s)) {
+      comps.species[s] = label;
+    }
+
+    for (auto c = comp_c.find_first(); c != Bitset::npos;
+         c = comp_c.find_next(c)) {
+      comps.characters[c] = label;
+    }
+
+    species -= comp_s;
+    characters -= comp_c;
+
+    if (label == i) {
+      comps.comp_species[i] = std::move(comp_s);
+      comps.comp_characters[i] = std::move(comp_c);
+    } else {
+      comps.comp_species.push_back(std::move(comp_s));
+      comps.comp_characters.push_back(std::move(comp_c));
+    }
+
+    label = comps.comp_species.size();
+  }
+}
+
+bool check_reduction(RBMatrix m, const std::list<SignedCharacter>& reduction,
+                     const std::list<size_t>& keep_c) {
+  if (!keep_c.empty()) {
+    // remove the edges of the characters that are not in keep_c
+    Bitset drop = m.characters;
+
+    for (const auto id : keep_c) {
+      if (id < drop.size()) drop.reset(id);
+    }
+
+    for (auto c = drop.find_first(); c != Bitset::npos;
+         c = drop.find_next(c)) {
+      clear_character(c, m);
+    }
+  }
+
+  // build the components of m starting from a single component
+  RBMatrixCheckComponents comps;
+  comps.species.assign(m.species.size(), 0);
+  comps.characters.assign(m.characters.size(), 0);
+  comps.comp_species.push_back(m.species);
+  comps.comp_characters.push_back(m.characters);
+  split_component(0, m, comps);
+
+  for (const auto& sc : reduction) {
+    // for each signed character in the reduction
+    size_t c = 0;
+
+    try {
+      c = get_character(sc.character, m);
+    } catch (const std::out_of_range& e) {
+      // m has no character with ID sc.character
+      return false;
+    }
+
+    const auto i = comps.characters[c];
+    const bool active = m.red_t[c].any();
+
+    // species adjacent to c, and species in the same component of c which
+    // are not adjacent to c
+    const Bitset adj = m.black_t[c] | m.red_t[c];
+    const Bitset dif = comps.comp_species[i] - adj;
+
+    if (sc.state == State::gain) {
+      // c+ is not feasible if c is active
+      if (active) break;
+
+      // realize the character c+:
+      // - add a red edge between c and each species in D(c) \ N(c)
+      // - delete all black edges incident on c
+      for (auto s = adj.find_first(); s != Bitset::npos;
+           s = adj.find_next(s)) {
+        remove_edge(s, c, m);
+      }
+
+      for (auto s = dif.find_first(); s != Bitset::npos;
+           s = dif.find_next(s)) {
+        add_edge(s, c, Color::red, m);
+      }
+    } else {
+      // c- is not feasible if c is inactive or if c is not connected to
+      // every species in its component
+      if (!active || dif.any()) break;
+
+      // realize the character c-:
+      // - delete all edges incident on c
+      clear_character(c, m);
+    }
+
+    // only the component of c may have been split
+    split_component(i, m, comps);
+  }
+
+  // the reduction is successful if there are no edges left in m
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    if (m.black_t[c].any() || m.red_t[c].any()) return false;
+  }
+
+  return true;
+}
@@ -3,25 +3,11 @@
 
 #include "hdgraph.hpp"
 #include "rbgraph.hpp"
+#include "rbmatrix.hpp"
 
 //=============================================================================
 // Auxiliary structs and classes
 
-/**
-  @brief Safe chain DFS Visitor exception
-
-  Thrown when \e initial_state_visitor finds a safe chain with a safe source
-*/
-class InitialState : public std::exception {
- public:
-  /**
-    @brief Returns the reason of the exception
-
-    @return C String
-  */
-  inline const char* what() const throw() { return "Found initial state"; }
-};
-
 /**
   @brief Reduce exception
 
@@ -38,7 +24,11 @@ class NoReduction : public std::exception {
 };
 
 /**
-  @brief DFS Visitor used in depth_first_search
+  @brief DFS Visitor used in initial_states
+
+  The event points are the ones of the Boost DFS visitors. The visit is
+  stopped (see stopped) as soon as a safe source is found, unless every safe
+  source is needed.
 */
 class initial_state_visitor : public boost::default_dfs_visitor {
  public:
@@ -133,7 +123,8 @@ class initial_state_visitor : public boost::default_dfs_visitor {
 
     Call \e safe_chain to check if \e chain is a safe chain. If it is, run
     Test 1 on \e source_v.
-    If Test 1 succeds, add \e source_v to the list of safe sources.
+    If Test 1 succeds, add \e source_v to the list of safe sources, and stop
+    the visit if only one safe source is needed.
     If Test 1 fails, add \e source_v to the list of sources (maybe safe).
 
     @param[in] v     Current vertex
@@ -170,12 +161,20 @@ class initial_state_visitor : public boost::default_dfs_visitor {
   */
   bool safe_source_test1(const HDGraph& hasse);
 
+  /**
+    @brief Check if the visit must be stopped
+
+    @return True if a safe source was found and the visit must be stopped
+  */
+  inline bool stopped() const { return m_stopped; }
+
  private:
   std::list<HDVertex>* const m_safe_sources{};
   std::list<HDVertex>* const m_sources{};
-  std::list<HDEdge> chain{};
+  arena::List<HDEdge> chain{};
   HDVertex source_v{};
   HDVertex last_v{};
+  bool m_stopped{};
 };
 
 //=============================================================================
@@ -198,6 +197,19 @@ class initial_state_visitor : public boost::default_dfs_visitor {
 */
 std::list<HDVertex> initial_states(const HDGraph& hasse);
 
+/**
+  @brief Build the Hasse diagram \e p of \e gm and return its safe sources
+
+  @param[in]     g  Red-black graph
+  @param[in,out] gm Maximal reducible graph of \e g (GRB|CM∪A), chains and
+                    sources are tested on it and then rolled back
+  @param[out]    p  Hasse diagram graph
+
+  @return List of safe sources of \e p
+*/
+std::list<HDVertex> safe_sources(const RBGraph& g, RBGraph& gm,
+                                 HDGraph& p);
+
 /**
   @brief Test if \e sources contain a source that satisfies the test 2 in
          \e hasse
@@ -266,6 +278,9 @@ bool is_partial(const std::list<SignedCharacter>& reduction);
   Then R is called a successful reduction for GRB.
   The extended c-reduction of R is the sequence of positive and negative
   characters obtained by the application of R to GRB.
+  With the exponential algorithm, the reductions of the graphs met along the
+  way are kept in a memo (bounded by memo::budget), so the same graph is not
+  reduced twice.
 
   @param[in,out] g Red-black graph
 
@@ -274,6 +289,50 @@ bool is_partial(const std::list<SignedCharacter>& reduction);
 */
 std::list<SignedCharacter> reduce(RBGraph& g);
 
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of a
+         reducible bit-matrix
+
+  Same as reduce(RBGraph&), but the free and universal characters and the
+  connected components are computed on the bit-matrix representation.
+
+  @param[in,out] m Red-black bit-matrix
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e m
+*/
+std::list<SignedCharacter> reduce(RBMatrix& m);
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of a
+         red-black graph, if the graph is reducible
+
+  Same as reduce(RBGraph&), but a graph that can't be reduced is reported by
+  the result instead of by a NoReduction exception.
+
+  @param[in,out] g Red-black graph
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e g, and bool = True if \e g is reducible.
+          An empty list and bool = False otherwise
+*/
+std::pair<std::list<SignedCharacter>, bool> try_reduce(RBGraph& g);
+
+/**
+  @brief Compute an extended c-reduction that is a successful reduction of a
+         red-black bit-matrix, if the bit-matrix is reducible
+
+  Same as reduce(RBMatrix&), but a bit-matrix that can't be reduced is
+  reported by the result instead of by a NoReduction exception.
+
+  @param[in,out] m Red-black bit-matrix
+
+  @return Realized characters (list of signed characters), that is a
+          c-reduction of \e m, and bool = True if \e m is reducible.
+          An empty list and bool = False otherwise
+*/
+std::pair<std::list<SignedCharacter>, bool> try_reduce(RBMatrix& m);
+
 /**
   @brief Realize the character \e c (+ or -) in \e g
 
@@ -342,6 +401,63 @@ std::pair<std::list<SignedCharacter>, bool> realize(const RBVertex v,
 std::pair<std::list<SignedCharacter>, bool> realize(
     const std::list<SignedCharacter>& lsc, RBGraph& g);
 
+/**
+  @brief Realize the character \e c (+ or -) in \e m
+
+  Same as realize(const SignedCharacter&, RBGraph&) on a bit-matrix.
+
+  @param[in]     sc SignedCharacter of \e m
+  @param[in,out] m  Red-black bit-matrix
+
+  @return Realized characters (list of signed characters).
+          If the realization was successful then the bool flag will be true.
+          When the flag is false, the returned list is empty
+*/
+std::pair<std::list<SignedCharacter>, bool> realize(const SignedCharacter& sc,
+                                                    RBMatrix& m);
+
+/**
+  @brief Realize the list of characters \e lsc (+ or - each) in \e m
+
+  Same as realize(const std::list<SignedCharacter>&, RBGraph&) on a
+  bit-matrix.
+
+  @param[in]     lsc List of signed characters of \e m
+  @param[in,out] m   Red-black bit-matrix
+
+  @return Realized characters (list of signed characters).
+          If the realizations were successful then the bool flag will be true.
+          When the flag is false, the returned list is empty
+*/
+std::pair<std::list<SignedCharacter>, bool> realize(
+    const std::list<SignedCharacter>& lsc, RBMatrix& m);
+
 bool is_complete(std::list<SignedCharacter> sc, const RBGraph& gm);
 
+//=============================================================================
+// Reduction verification
+
+/**
+  @brief Check if \e reduction is a successful c-reduction of \e m
+
+  The signed characters in \e reduction are replayed on \e m in order, with
+  no other realization in between (free characters are not realized
+  automatically): c+ is feasible if c is inactive, c- is feasible if c is
+  active and its connected component has no species that are not adjacent
+  to c.
+  The replay stops at the first signed character that is not feasible.
+  Connected components are updated by relabelling only the component of the
+  realized character.
+
+  @param[in] m         Red-black bit-matrix of the input graph
+  @param[in] reduction Reduction (list of signed characters of \e m)
+  @param[in] keep_c    IDs of the characters of \e m to keep, the edges of
+                       the other characters are removed before the replay
+                       (no character is removed if \e keep_c is empty)
+
+  @return True if \e m has no edges left after the replay
+*/
+bool check_reduction(RBMatrix m, const std::list<SignedCharacter>& reduction,
+                     const std::list<size_t>& keep_c = {});
+
 #endif
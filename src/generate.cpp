@@ -0,0 +1,320 @@
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <random>
+#include "rbgraph.hpp"
+
+/**
+  @brief Rows of a matrix that has no persistent phylogeny (see
+         tests/test_6x3.txt), planted in the unsolvable instances
+*/
+static const bool unsolvable_rows[6][3] = {
+    {0, 0, 1}, {0, 1, 0}, {0, 1, 1}, {1, 0, 0}, {1, 0, 1}, {1, 1, 0}};
+
+/**
+  @brief Generate the matrix of the species of a random persistent phylogeny
+
+  The tree is built by merging random pairs of subtrees, starting from the
+  species (the leaves), until the root is left.
+  Each character is gained once, above the root if it's active, or on the
+  edge above a random node which is not the root otherwise.
+  Lost characters are also lost once, on the edge above a random node in the
+  subtree of the node where they are gained.
+
+  @param[in]  num_s  Number of species (at least 3 if an inactive character
+                     is lost, at least 2 otherwise)
+  @param[in]  active Characters that are active
+  @param[in]  lost   Characters that are lost
+  @param[in]  rng    Random number generator
+  @param[out] matrix States of the characters of each species
+*/
+static void simulate_phylogeny(const size_t num_s,
+                               const std::vector<bool>& active,
+                               const std::vector<bool>& lost,
+                               std::mt19937_64& rng,
+                               std::vector<std::vector<bool>>& matrix) {
+  const auto num_c = active.size();
+
+  // nodes: the species, then the internal nodes in order of creation, so
+  // that each node comes before its parent and the root is the last one
+  const auto num_n = 2 * num_s - 1;
+  const auto root = num_n - 1;
+  std::vector<size_t> parent(num_n, num_n);
+  std::vector<size_t> subtrees(num_s);
+
+  for (size_t i = 0; i < num_s; ++i) {
+    subtrees[i] = i;
+  }
+
+  for (size_t node = num_s; node < num_n; ++node) {
+    // merge two random subtrees under node
+    for (size_t k = 0; k < 2; ++k) {
+      const auto j = std::uniform_int_distribution<size_t>(
+          0, subtrees.size() - 1)(rng);
+
+      parent[subtrees[j]] = node;
+      subtrees[j] = subtrees.back();
+      subtrees.pop_back();
+    }
+
+    subtrees.push_back(node);
+  }
+
+  // gain[c] and loss[c] are the nodes below the edges where c is gained and
+  // lost (root if c is gained above the root, num_n if c is not lost)
+  std::vector<size_t> gain(num_c, root), loss(num_c, num_n);
+
+  for (size_t c = 0; c < num_c; ++c) {
+    if (active[c]) continue;
+
+    // an inactive character that is lost is gained above an internal node
+    const size_t first = (lost[c] ? num_s : 0);
+    gain[c] = std::uniform_int_distribution<size_t>(first, root - 1)(rng);
+  }
+
+  for (size_t c = 0; c < num_c; ++c) {
+    if (!lost[c]) continue;
+
+    // the nodes in the subtree of gain[c] all come before it, so random
+    // nodes are drawn until one of them is found
+    while (loss[c] == num_n) {
+      const auto node =
+          std::uniform_int_distribution<size_t>(0, gain[c] - 1)(rng);
+
+      auto u = node;
+      while (u < gain[c]) u = parent[u];
+
+      if (u == gain[c]) loss[c] = node;
+    }
+  }
+
+  // states of the nodes, from the root down
+  std::vector<std::vector<bool>> states(num_n, std::vector<bool>(num_c));
+
+  for (auto node = num_n; node-- > 0;) {
+    if (node != root) states[node] = states[parent[node]];
+
+    for (size_t c = 0; c < num_c; ++c) {
+      if (gain[c] == node) states[node][c] = true;
+      if (loss[c] == node) states[node][c] = false;
+    }
+  }
+
+  matrix.assign(states.begin(), states.begin() + num_s);
+}
+
+/**
+  @brief Return \e k distinct random indices in [0, \e n)
+
+  @param[in] n   Number of indices
+  @param[in] k   Number of indices drawn
+  @param[in] rng Random number generator
+
+  @return Indices
+*/
+static std::vector<size_t> sample(const size_t n, const size_t k,
+                                  std::mt19937_64& rng) {
+  std::vector<size_t> indices(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    indices[i] = i;
+  }
+
+  std::shuffle(indices.begin(), indices.end(), rng);
+  indices.resize(k);
+
+  return indices;
+}
+
+int main(int argc, const char* argv[]) {
+  // declare the output file
+  std::vector<std::string> files;
+
+  // initialize options menu
+  boost::program_options::options_description general_options(
+      "Usage: ppp-generate [OPTION...] OUTPUT"
+      "\n"
+      "Write to OUTPUT a random matrix which has a persistent phylogeny, or "
+      "which has none with --unsolvable."
+      "\n\n"
+      "Options");
+
+  general_options.add_options()
+      // option: help message
+      ("help,h", "Display this message.\n")
+      // option: species, number of species
+      ("species,s", boost::program_options::value<size_t>()->default_value(10),
+       "Number of species.\n")
+      // option: characters, number of characters
+      ("characters,c",
+       boost::program_options::value<size_t>()->default_value(5),
+       "Number of characters.\n")
+      // option: active, fraction of active characters
+      ("active,a", boost::program_options::value<double>()->default_value(0),
+       "Fraction of the characters that are active, i.e. gained above the "
+       "root of the phylogeny.\n")
+      // option: losses, number of characters lost
+      ("losses,l", boost::program_options::value<size_t>()->default_value(0),
+       "Number of characters lost in the phylogeny.\n")
+      // option: unsolvable, plant a matrix with no persistent phylogeny
+      ("unsolvable,u",
+       boost::program_options::bool_switch()->default_value(false),
+       "Overwrite 6 species and 3 inactive characters of the matrix with one "
+       "that has no persistent phylogeny, so that the whole matrix has none.\n")
+      // option: seed, seed of the random number generator
+      ("seed", boost::program_options::value<size_t>()->default_value(0),
+       "Seed of the random number generator.\n")
+      // option: binary, write the binary format
+      ("binary,b", boost::program_options::bool_switch()->default_value(false),
+       "Write the binary format instead of the text format.\n");
+
+  // initialize hidden options (not shown in --help)
+  boost::program_options::options_description hidden_options;
+  // option: output file
+  hidden_options.add_options()(
+      "files", boost::program_options::value<std::vector<std::string>>(&files));
+
+  // initialize positional options
+  boost::program_options::positional_options_description positional_options;
+  // add output file to the positional options
+  positional_options.add("files", 1);
+
+  // initialize options
+  boost::program_options::options_description cmdline_options;
+  // add the options menu and the hidden options to the available options
+  cmdline_options.add(general_options).add(hidden_options);
+
+  // initialize the variables map
+  boost::program_options::variables_map vm;
+
+  try {
+    // parse the options given in input, and check them against positional and
+    // cmdline options: store the result in vm
+    boost::program_options::store(
+        boost::program_options::command_line_parser(argc, argv)
+            .positional(positional_options)
+            .options(cmdline_options)
+            .run(),
+        vm);
+
+    boost::program_options::notify(vm);
+  } catch (const std::exception& e) {
+    // error while parsing the options given in input
+    std::cerr << "Error: " << e.what() << "." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    // help
+    std::cout << general_options << std::endl;
+
+    return 0;
+  }
+
+  if (files.size() != 1) {
+    // output file not specified
+    std::cerr << "Error: No output file specified." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  const auto num_s = vm["species"].as<size_t>();
+  const auto num_c = vm["characters"].as<size_t>();
+  const auto active = vm["active"].as<double>();
+  const auto num_l = vm["losses"].as<size_t>();
+  const bool unsolvable = vm["unsolvable"].as<bool>();
+
+  const auto num_a =
+      static_cast<size_t>(std::round(std::min(std::max(active, 0.0), 1.0) *
+                                     num_c));
+
+  std::string error;
+
+  if (num_s < 2 || num_c == 0)
+    error = "At least 2 species and 1 character are needed";
+  else if (active < 0 || active > 1)
+    error = "The fraction of active characters must be between 0 and 1";
+  else if (num_l > num_c)
+    error = "More losses than characters";
+  else if (num_l > num_a && num_s < 3)
+    error = "Inactive characters can't be lost with less than 3 species";
+  else if (unsolvable && (num_s < 6 || num_c - num_a < 3))
+    error = "Unsolvable matrices need 6 species and 3 inactive characters";
+
+  if (!error.empty()) {
+    std::cerr << "Error: " << error << "." << std::endl
+              << "Try '" << argv[0] << " --help' for more information."
+              << std::endl;
+
+    return 1;
+  }
+
+  std::mt19937_64 rng(vm["seed"].as<size_t>());
+
+  std::vector<bool> is_active(num_c), is_lost(num_c);
+  for (const auto c : sample(num_c, num_a, rng)) is_active[c] = true;
+  for (const auto c : sample(num_c, num_l, rng)) is_lost[c] = true;
+
+  if (num_s < 3) {
+    // lose active characters first
+    for (size_t c = 0, n = 0; c < num_c; ++c) {
+      is_lost[c] = (is_active[c] && n++ < num_l);
+    }
+  }
+
+  std::vector<std::vector<bool>> matrix;
+  simulate_phylogeny(num_s, is_active, is_lost, rng, matrix);
+
+  if (unsolvable) {
+    // plant the matrix in random species and inactive characters
+    std::vector<size_t> inactive;
+    for (size_t c = 0; c < num_c; ++c) {
+      if (!is_active[c]) inactive.push_back(c);
+    }
+
+    const auto s_plant = sample(num_s, 6, rng);
+    auto c_plant = sample(inactive.size(), 3, rng);
+
+    for (size_t i = 0; i < 6; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        matrix[s_plant[i]][inactive[c_plant[j]]] = unsolvable_rows[i][j];
+      }
+    }
+  }
+
+  RBGraph g;
+  std::vector<RBVertex> species(num_s), characters(num_c);
+
+  for (size_t s = 0; s < num_s; ++s) {
+    species[s] = add_vertex("s" + std::to_string(s), Type::species, g);
+  }
+
+  for (size_t c = 0; c < num_c; ++c) {
+    characters[c] = add_vertex("c" + std::to_string(c), Type::character, g);
+  }
+
+  for (size_t s = 0; s < num_s; ++s) {
+    for (size_t c = 0; c < num_c; ++c) {
+      // active characters are connected to the species that lost them
+      if (matrix[s][c] != is_active[c]) add_edge(species[s], characters[c], g);
+    }
+  }
+
+  for (size_t c = 0; c < num_c; ++c) {
+    if (is_active[c]) change_char_type(characters[c], g);
+  }
+
+  try {
+    write_graph(files[0], g, vm["binary"].as<bool>());
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "." << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
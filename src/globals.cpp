@@ -1,18 +1,91 @@
 #include "globals.hpp"
+#include <iostream>
 
 //=============================================================================
 // Output modifiers
 
-bool logging::enabled = false;
+thread_local bool logging::enabled = false;
+
+thread_local std::ostream* logging::stream = &std::cout;
+
+thread_local stats::Stats* stats::current = nullptr;
+
+thread_local size_t stats::depth = 0;
+
+thread_local trace::Trace* trace::current = nullptr;
+
+thread_local size_t trace::run = 0;
 
 //=============================================================================
 // Algorithm modifiers
 
-bool exponential::enabled = false;
+thread_local bool exponential::enabled = false;
+
+thread_local exponential::Strategy exponential::strategy =
+    exponential::Strategy::all;
+
+thread_local std::atomic<size_t>* exponential::count = nullptr;
+
+thread_local bool interactive::enabled = false;
+
+thread_local size_t nthsource::index = 0;
+
+thread_local bool active::enabled = false;
+
+thread_local size_t parallel::threads = 1;
+
+thread_local size_t parallel::grain = 64;
+
+thread_local size_t memo::budget = 64 << 20;
+
+//=============================================================================
+// Representation modifiers
+
+#ifdef BITMATRIX
+thread_local bool bitmatrix::enabled = true;
+#else
+thread_local bool bitmatrix::enabled = false;
+#endif
+
+//=============================================================================
+// Run configuration
 
-bool interactive::enabled = false;
+RunConfig save_config() {
+  RunConfig config;
 
-size_t nthsource::index = 0;
+  config.logging_enabled = logging::enabled;
+  config.exponential_enabled = exponential::enabled;
+  config.exponential_strategy = exponential::strategy;
+  config.exponential_count = exponential::count;
+  config.interactive_enabled = interactive::enabled;
+  config.nthsource_index = nthsource::index;
+  config.active_enabled = active::enabled;
+  config.parallel_threads = parallel::threads;
+  config.parallel_grain = parallel::grain;
+  config.memo_budget = memo::budget;
+  config.bitmatrix_enabled = bitmatrix::enabled;
+  config.stats_current = stats::current;
+  config.stats_depth = stats::depth;
+  config.trace_current = trace::current;
+  config.trace_run = trace::run;
 
-bool active::enabled = false;
+  return config;
+}
 
+void load_config(const RunConfig& config) {
+  logging::enabled = config.logging_enabled;
+  exponential::enabled = config.exponential_enabled;
+  exponential::strategy = config.exponential_strategy;
+  exponential::count = config.exponential_count;
+  interactive::enabled = config.interactive_enabled;
+  nthsource::index = config.nthsource_index;
+  active::enabled = config.active_enabled;
+  parallel::threads = config.parallel_threads;
+  parallel::grain = config.parallel_grain;
+  memo::budget = config.memo_budget;
+  bitmatrix::enabled = config.bitmatrix_enabled;
+  stats::current = config.stats_current;
+  stats::depth = config.stats_depth;
+  trace::current = config.trace_current;
+  trace::run = config.trace_run;
+}
@@ -1,17 +1,64 @@
 #ifndef GLOBALS_HPP
 #define GLOBALS_HPP
 
+#include <atomic>
+#include <iosfwd>
 #include <list>
 #include <string>
 
 //=============================================================================
 // Output modifiers
 
+/**
+  @brief Highest logging level compiled in: 0 removes every logging statement
+         of the algorithm, 1 keeps the verbose output, 2 (default) keeps the
+         trace of the DFS visits too
+*/
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 2
+#endif
+
+/**
+  @brief Check if the logging statements of \e level are enabled
+
+  The check is false at compile time if \e level is above LOG_LEVEL, so the
+  statements it guards are removed from the build.
+
+  @param[in] level Logging level (verbose or trace)
+
+  @return True if logging is enabled at \e level
+*/
+#define LOGGING(level) (logging::level <= LOG_LEVEL && logging::enabled)
+
 /**
   @brief Global logging namespace
 */
 namespace logging {
-extern bool enabled;  ///< Logging toggle
+constexpr int verbose = 1;  ///< Level of the verbose output
+constexpr int trace = 2;    ///< Level of the trace of the DFS visits
+
+extern thread_local bool enabled;          ///< Logging toggle
+extern thread_local std::ostream* stream;  ///< Logging output stream
+};
+
+/**
+  @brief Global run statistics namespace (see stats.hpp)
+*/
+namespace stats {
+struct Stats;
+
+extern thread_local Stats* current;  ///< Statistics of the run (or nullptr)
+extern thread_local size_t depth;    ///< Depth of the reduction recursion
+};
+
+/**
+  @brief Global reduction trace namespace (see trace.hpp)
+*/
+namespace trace {
+class Trace;
+
+extern thread_local Trace* current;  ///< Trace of the run (or nullptr)
+extern thread_local size_t run;      ///< Index of the run in the trace
 };
 
 //=============================================================================
@@ -21,30 +68,119 @@ extern bool enabled;  ///< Logging toggle
   @brief Global exponential algorithm namespace
 */
 namespace exponential {
-extern bool enabled;  ///< Exponential algorithm toggle
+/**
+  @brief Scoped enumeration type of the strategies of the exponential
+         algorithm, i.e. what is done with the successful reductions found
+         for the safe sources of a graph
+
+  - all: keep every one of them, one list for each successful safe source at
+    each level of the recursion (the reduction returned is the first one);
+  - first: stop at the first successful safe source, keeping one list for
+    each level of the recursion;
+  - count: count them in exponential::count, keeping one list for each level
+    of the recursion;
+  - stream: write each one to logging::stream as soon as it's found, keeping
+    one list for each level of the recursion.
+*/
+enum class Strategy { all, first, count, stream };
+
+extern thread_local bool enabled;                ///< Algorithm toggle
+extern thread_local Strategy strategy;           ///< Algorithm strategy
+extern thread_local std::atomic<size_t>* count;  ///< Successful reductions
 };
 
 /**
   @brief Global user interaction namespace
 */
 namespace interactive {
-extern bool enabled;  ///< User interaction toggle
+extern thread_local bool enabled;  ///< User interaction toggle
 };
 
 /**
   @brief Global safe source selection namespace
 */
 namespace nthsource {
-extern size_t index;  ///< Safe source index selection
+extern thread_local size_t index;  ///< Safe source index selection
 };
 
 /**
   @brief Global active character filter namespace
 */
 namespace active {
-extern bool enabled;  ///< Safe source index selection
+extern thread_local bool enabled;  ///< Safe source index selection
+};
+
+/**
+  @brief Global parallel reduction namespace
+*/
+namespace parallel {
+extern thread_local size_t threads;  ///< Number of task pool threads
+extern thread_local size_t grain;    ///< Minimum size of a parallel component
 };
 
+/**
+  @brief Global reduction memo namespace
+*/
+namespace memo {
+extern thread_local size_t budget;  ///< Memory budget of the memo (bytes)
+};
+
+//=============================================================================
+// Representation modifiers
+
+/**
+  @brief Global bit-matrix representation namespace
+*/
+namespace bitmatrix {
+extern thread_local bool enabled;  ///< Bit-matrix red-black graph toggle
+};
+
+//=============================================================================
+// Run configuration
+
+/**
+  @brief Struct used to represent the modifiers of a run
+
+  Modifiers are thread-local, so each thread running the algorithm has its
+  own copy of them: a worker thread loads the configuration of the thread
+  that started it before running the algorithm.
+*/
+struct RunConfig {
+  bool logging_enabled{};      ///< Logging toggle
+  bool exponential_enabled{};  ///< Exponential algorithm toggle
+  bool interactive_enabled{};  ///< User interaction toggle
+  size_t nthsource_index{};    ///< Safe source index selection
+  bool active_enabled{};       ///< Active character filter toggle
+  size_t parallel_threads{};   ///< Number of task pool threads
+  size_t parallel_grain{};     ///< Minimum size of a parallel component
+  size_t memo_budget{};        ///< Memory budget of the memo (bytes)
+  bool bitmatrix_enabled{};    ///< Bit-matrix red-black graph toggle
+
+  exponential::Strategy exponential_strategy{};  ///< Exponential strategy
+  std::atomic<size_t>* exponential_count{};      ///< Successful reductions
+  stats::Stats* stats_current{};                 ///< Statistics of the run
+  size_t stats_depth{};                          ///< Depth of the recursion
+  trace::Trace* trace_current{};                 ///< Trace of the run
+  size_t trace_run{};                            ///< Index of the run
+};
+
+/**
+  @brief Return the modifiers of the calling thread
+
+  @return Run configuration
+*/
+RunConfig save_config();
+
+/**
+  @brief Set the modifiers of the calling thread to \e config
+
+  The logging output stream is not part of the configuration, it's left
+  unchanged.
+
+  @param[in] config Run configuration
+*/
+void load_config(const RunConfig& config);
+
 //=============================================================================
 // Typedefs used for readabily
 
@@ -1,6 +1,7 @@
 #include <algorithm>
-#include <boost/graph/connected_components.hpp>
+#include <unordered_map>
 #include "hdgraph.hpp"
+#include "stats.hpp"
 
 
 //=============================================================================
@@ -8,11 +9,20 @@
 
 // Hasse Diagram
 
-HDVertex add_vertex(const std::list<std::string>& species,
-                    const std::list<std::string>& characters, HDGraph& hasse) {
+HDVertex add_vertex(const std::list<size_t>& species,
+                    const std::list<size_t>& characters, HDGraph& hasse) {
   const auto v = boost::add_vertex(hasse);
-  hasse[v].species = species;
-  hasse[v].characters = characters;
+  hasse[v].species.assign(species.cbegin(), species.cend());
+  hasse[v].characters.assign(characters.cbegin(), characters.cend());
+  hasse[boost::graph_bundle].num_v++;
+  return v;
+}
+
+HDVertex add_vertex(const size_t species, const std::list<size_t>& characters,
+                    HDGraph& hasse) {
+  const auto v = boost::add_vertex(hasse);
+  hasse[v].species.push_back(species);
+  hasse[v].characters.assign(characters.cbegin(), characters.cend());
   hasse[boost::graph_bundle].num_v++;
   return v;
 }
@@ -23,7 +33,8 @@ std::pair<HDEdge, bool> add_edge(
   HDEdge e;
   bool exists;
   std::tie(e, exists) = boost::add_edge(u, v, hasse);
-  hasse[e].signedcharacters = signedcharacters;
+  hasse[e].signedcharacters.assign(signedcharacters.cbegin(),
+                                   signedcharacters.cend());
 
   return std::make_pair(e, exists);
 }
@@ -40,13 +51,13 @@ std::ostream& operator<<(std::ostream& os, const HDGraph& hasse) {
     os << "[ ";
 
     for (const auto& i : hasse[*v].species) {
-      os << i << " ";
+      os << get_name(i, Type::species) << " ";
     }
 
     os << "( ";
 
     for (const auto& i : hasse[*v].characters) {
-      os << i << " ";
+      os << get_name(i, Type::character) << " ";
     }
 
     os << ") ]:";
@@ -67,13 +78,13 @@ std::ostream& operator<<(std::ostream& os, const HDGraph& hasse) {
       os << "-> [ ";
 
         for (const auto& i : hasse[vt].species) {
-          os << i << " ";
+          os << get_name(i, Type::species) << " ";
         }
 
       os << "( ";
 
       for (const auto& i : hasse[vt].characters) {
-        os << i << " ";
+        os << get_name(i, Type::character) << " ";
       }
 
       os << ") ];";
@@ -88,173 +99,138 @@ std::ostream& operator<<(std::ostream& os, const HDGraph& hasse) {
 //=============================================================================
 // Algorithm functions
 
-bool is_included(const std::list<std::string>& a,
-                 const std::list<std::string>& b) {
-  for (const auto& a_str : a) {
-    if (std::find(b.cbegin(), b.cend(), a_str) == b.cend())
-      // exit the function at the first string of a not present in b
+bool is_included(const std::list<size_t>& a, const std::list<size_t>& b) {
+  for (const auto& a_id : a) {
+    if (std::find(b.cbegin(), b.cend(), a_id) == b.cend())
+      // exit the function at the first ID of a not present in b
       return false;
   }
   return true;
 }
 
-void hasse_diagram(HDGraph& hasse, const RBGraph& g, const RBGraph& gm, const RBGraphVector& components, const RBVertexIMap& c_map) {
-  std::vector<std::list<RBVertex>> vec_adj_char(num_species(gm));
-  std::map<RBVertex, std::list<RBVertex>> adj_char;
-  hasse[boost::graph_bundle].num_v = 0;
-  // how vec_adj_char is going to be structured:
-  // vec_adj_char[index] => < S, List of characters adjacent to S >
-
-  // how adj_char is going to be structured:
-  // adj_char[S] => < List of characters adjacent to S >
-
-  // vec_adj_char is used to sort the lists by number of elements, this is why
-  // we store the list of adjacent characters to S. While we store S to be able
-  // to access adj_char[S] in costant time, instead of iterating on vec_adj_char
-  // to find the correct list
-
-  auto compare_names = [](const std::string& a, const std::string& b) {
-    size_t a_index, b_index;
-    std::stringstream ss;
+void hasse_diagram(HDGraph& hasse, const RBGraph& g, RBGraph& gm) {
+  const stats::Timer timer(stats::Stage::hasse_diagram);
 
-    ss.str(a.substr(1));
-    ss >> a_index;
-
-    ss.clear();
-
-    ss.str(b.substr(1));
-    ss >> b_index;
+  // species of gm, each one with its set of adjacent characters (IDs)
+  std::vector<RBVertex> species;
+  std::vector<Bitset> adj_char;
+  hasse[boost::graph_bundle].num_v = 0;
 
-    return a_index < b_index;
-  };
+  const auto n_characters = vertex_map(Type::character, gm).size();
 
-  // initialize vec_adj_char and adj_char for each species in the graph
+  // initialize species and adj_char for each species in the graph
   RBVertexIter v, v_end;
   std::tie(v, v_end) = vertices(gm);
-  for (size_t index = 0; v != v_end; ++v) {
+  for (; v != v_end; ++v) {
     if (!is_species(*v, gm)) continue;
     // for each species vertex
-    
-    // vec_adj_char[index]'s first element is the species vertex
-    vec_adj_char[index].push_back(*v);
 
     // build v's set of adjacent characters
+    Bitset characters(n_characters);
+
     RBOutEdgeIter e, e_end;
     std::tie(e, e_end) = out_edges(*v, gm);
     for (; e != e_end; ++e) {
       //ignore active characters
       if(!active::enabled && is_red(*e, gm)) continue;
-      
-      // vt = one of the characters adjacent to *v
-      const auto vt = target(*e, gm);
 
-      // vec_adj_char[index]'s other elements are the characters adjacent to S
-      vec_adj_char[index].push_back(vt);
-      // adj_char[S]'s elements are the characters adjacent to S
-      adj_char[*v].push_back(vt);
+      characters.set(gm[target(*e, gm)].id);
     }
 
     // if the species *v would have 0 characters, ignore it
-    if (vec_adj_char[index].size() == 1) {
-      vec_adj_char[index].clear();
+    if (characters.none()) continue;
 
-      continue;
-    }
-
-    index++;
+    species.push_back(*v);
+    adj_char.push_back(std::move(characters));
   }
 
-  auto compare_size = [](const std::list<RBVertex>& a,
-                         const std::list<RBVertex>& b) {
-    return a.size() < b.size();
-  };
+  // sort the species by number of characters in ascending order.
+  // order has a slot for each species of gm, the slots after the last species
+  // with characters are empty and sort first (this keeps the order of species
+  // with the same number of characters unchanged)
+  std::vector<std::pair<size_t, size_t>> order(num_species(gm), {0, 0});
+  for (size_t index = 0; index < species.size(); ++index) {
+    order[index] = {adj_char[index].count(), index};
+  }
 
-  // sort vec_adj_char by size in ascending order
-  std::sort(vec_adj_char.begin(), vec_adj_char.end(), compare_size);
+  std::sort(order.begin(), order.end(),
+            [](const std::pair<size_t, size_t>& a,
+               const std::pair<size_t, size_t>& b) {
+              return a.first < b.first;
+            });
 
-  bool first_iteration = true;
-  for (const auto& set : vec_adj_char) {
-    // for each set of characters
-    if (set.empty()) continue;
+  // vertex of the Hasse diagram with a given set of characters
+  std::unordered_map<Bitset, HDVertex, std::hash<Bitset>,
+                     std::equal_to<Bitset>,
+                     arena::Allocator<std::pair<const Bitset, HDVertex>>>
+      hd_vertex;
 
-    // v = species of gm
-    const auto v = set.front();
+  // layers[k] holds the vertices of the Hasse diagram with k characters, along
+  // with their set of characters
+  std::vector<arena::List<std::pair<const Bitset*, HDVertex>>> layers(
+      n_characters + 1);
 
-    // fill the list of characters names of v
-    std::list<std::string> lcv{};
-    for (const auto& cv : adj_char[v]) {
-      lcv.push_back(gm[cv].name);
-    }
+  for (const auto& slot : order) {
+    if (slot.first == 0) continue;
+    // for each species with characters, by number of characters
 
-    lcv.sort(compare_names);
+    const auto& characters = adj_char[slot.second];
+    const auto id = gm[species[slot.second]].id;
 
-    if (first_iteration) {
-      // first iteration of the loop:
-      // add v to the Hasse diagram, and being the first vertex of the graph
-      // there's no need to do any work
-      add_vertex(gm[v].name, lcv, hasse);
+    const auto same = hd_vertex.find(characters);
 
-      first_iteration = false;
+    if (same != hd_vertex.end()) {
+      // there is a vertex with the same characters as v: add v to the list of
+      // species in that vertex
+      hasse[same->second].species.push_back(id);
 
       continue;
     }
 
-    // new_edges will contain the list of edges that may be added to the Hasse
-    // diagram: HDVertex is the source, std::string is the edge label
-    std::list<std::pair<HDVertex, std::string>> new_edges;
-
-    // check if there is a vertex with the same characters as v or if v needs
-    // to be added to the Hasse diagram
-    HDVertexIter hdv, hdv_end;
-    std::tie(hdv, hdv_end) = vertices(hasse);
-    for (; hdv != hdv_end; ++hdv) {
-      // for each vertex in hasse
-
-      if (lcv == hasse[*hdv].characters) {
-        // v and hdv have the same characters
-
-        // add v to the list of species in hdv
-        hasse[*hdv].species.push_back(gm[v].name);
-
-        break;
-      }
+    // the vertices covered by v are the largest ones whose characters are
+    // included in v's (the smaller ones are included in them too, so they are
+    // connected to v by a path): visit the layers by number of characters in
+    // descending order, all of them have less characters than v
+    arena::List<std::pair<const Bitset*, HDVertex>> covered;
 
-      const std::list<std::string> lhdv = hasse[*hdv].characters;
+    for (size_t k = slot.first; k-- > 0;) {
+      for (const auto& w : layers[k]) {
+        if (!w.first->is_subset_of(characters)) continue;
 
-      // initialize new_edges if lhdv is a subset of lcv, with the structure:
-      // *hdv -*ci-> v
-      if (is_included(lhdv, lcv)) {
-        // hdv is included in v
-        for (const auto& ci : lcv) {
-          // for each character in hdv
-          const auto in = std::find(lhdv.cbegin(), lhdv.cend(), ci);
+        const auto included = std::any_of(
+            covered.cbegin(), covered.cend(),
+            [&](const std::pair<const Bitset*, HDVertex>& u) {
+              return w.first->is_subset_of(*u.first);
+            });
 
-          if (in == lhdv.end()) {
-            // character is not present in lhdv
-            new_edges.push_back(std::make_pair(*hdv, ci));
-          }
-        }
+        if (!included) covered.push_back(w);
       }
+    }
 
-      // on the last iteration of the cycle, after having collected all the
-      // pairs in new_edges, add vertex and edges to the Hasse diagram
-      if (std::next(hdv) == hdv_end) {
-        // last iteration on the characters in the list has been performed
+    // build a vertex for v and add it to the Hasse diagram, then fill its
+    // list of characters IDs
+    const auto u = add_vertex(id, {}, hasse);
+    for (auto ci = characters.find_first(); ci != Bitset::npos;
+         ci = characters.find_next(ci)) {
+      hasse[u].characters.push_back(ci);
+    }
 
-        // build a vertex for v and add it to the Hasse diagram
-        const auto u = add_vertex(gm[v].name, lcv, hasse);
+    // build in_edges for the vertex and add them to the Hasse diagram, each
+    // edge is labeled with the characters of v that are not in the source
+    for (const auto& w : covered) {
+      const auto gained = characters - *w.first;
 
-        // build in_edges for the vertex and add them to the Hasse diagram
-        for (const auto& ei : new_edges) {
-          // for each new edge to add to the Hasse diagram
-          HDEdge edge;
-          std::tie(edge, std::ignore) = add_edge(ei.first, u, hasse);
-          hasse[edge].signedcharacters.push_back({ei.second, State::gain});
-        }
+      HDEdge edge;
+      std::tie(edge, std::ignore) = add_edge(w.second, u, hasse);
 
-        break;
+      for (auto ci = gained.find_first(); ci != Bitset::npos;
+           ci = gained.find_next(ci)) {
+        hasse[edge].signedcharacters.push_back({ci, State::gain});
       }
     }
+
+    const auto v_characters = hd_vertex.emplace(characters, u).first;
+    layers[slot.first].push_back({&v_characters->first, u});
   }
 
   // Store the graph pointer into the Hasse diagram's graph properties
@@ -264,20 +240,12 @@ void hasse_diagram(HDGraph& hasse, const RBGraph& g, const RBGraph& gm, const RB
   // properties
   hasse[boost::graph_bundle].gm = &gm;
 
-  // sort species names in each vertex
+  // sort species IDs in each vertex
   HDVertexIter u, u_end;
   std::tie(u, u_end) = vertices(hasse);
   for (; u != u_end; ++u) {
-    auto species = hasse[*u].species;
-
-    species.sort(compare_names);
-
-    hasse[*u].species.clear();
-    hasse[*u].species.splice(hasse[*u].species.cend(), species);
+    hasse[*u].species.sort();
   }
-   
-  
-  transitive_reduction(hasse);
 }
 
 void reduce_diagram(HDGraph& hasse, const RBGraph& gm){
@@ -286,22 +254,22 @@ void reduce_diagram(HDGraph& hasse, const RBGraph& gm){
   HDVertexIter hdv, hdv_end;  //Hasse diagram vertexes
 
   //List of species that must be deleted from the HDGraph
-  std::set<std::string> acl, acc, sset; //set of species that must be deleted;
+  std::set<size_t> acl, acc, sset; //set of species that must be deleted;
   std::tie(rbv, rbv_end) = vertices(gm);
   while(rbv != rbv_end) {
     if(!is_character(*rbv, gm)) {
       acl = specie_active_characters(*rbv, gm);
       acc = comp_active_characters(*rbv, gm);
       if(acl.size() < acc.size())
-        sset.insert(gm[*rbv].name);
+        sset.insert(gm[*rbv].id);
     }
     rbv++;
   }
-  if(logging::enabled) {
-    std::cout << "Species that doesn't include all active characters: ";
-    for(std::string s : sset)
-      std::cout << s << " ";
-    std::cout << std::endl << std::endl;
+  if (LOGGING(verbose)) {
+    *logging::stream << "Species that doesn't include all active characters: ";
+    for(const auto s : sset)
+      *logging::stream << get_name(s, Type::species) << " ";
+    *logging::stream << std::endl << std::endl;
   }
 
   //Removes ls species from Hasse vertexes
@@ -2,6 +2,8 @@
 #define HDGRAPH_HPP
 
 #include <boost/graph/graph_utility.hpp>
+#include <set>
+#include "arena.hpp"
 #include "globals.hpp"
 #include "rbgraph.hpp"
 
@@ -25,7 +27,7 @@ enum class State : bool {
   Each character c+ and c− is called a signed character.
 */
 struct SignedCharacter {
-  std::string character{};    ///< Character name
+  size_t character{};         ///< Character ID
   State state = State::gain;  ///< Character state
 };
 
@@ -44,8 +46,9 @@ struct SignedCharacter {
   For each character c, we allow at most one edge labeled by c−.
 */
 struct HDEdgeProperties {
-  std::list<SignedCharacter> signedcharacters{};  ///< List of SignedCharacters
-                                                  ///< that label the edge
+  arena::List<SignedCharacter> signedcharacters{};  ///< List of
+                                                    ///< SignedCharacters that
+                                                    ///< label the edge
 };
 
 /**
@@ -57,19 +60,63 @@ struct HDEdgeProperties {
   species of GM ordered by the relation ≤, where s1 ≤ s2 if C(s1) ⊆ C(s2).
 */
 struct HDVertexProperties {
-  std::list<std::string> species{};  ///< List of species that label the vertex
-  std::list<std::string> characters{};  ///< List of characters of the species
+  arena::List<size_t> species{};     ///< List of species (IDs) that label the
+                                     ///< vertex
+  arena::List<size_t> characters{};  ///< List of characters (IDs) of the
+                                     ///< species
 };
 
 /**
   @brief Struct used to represent the properties of a Hasse diagram
 */
 struct HDGraphProperties {
-  const RBGraph* g{};   ///< Original red-black graph
-  const RBGraph* gm{};  ///< Original maximal reducible graph
+  const RBGraph* g{};  ///< Original red-black graph
+  RBGraph* gm{};       ///< Original maximal reducible graph, chains and
+                       ///< sources are tested on it and then rolled back
   size_t num_v; ///< Number of vertices
 };
 
+//=============================================================================
+// Container selectors
+
+/**
+  Selector of a list allocated from the arena of the Scope where the Hasse
+  diagram is built (see arena::Allocator)
+*/
+struct arena_listS {};
+
+/**
+  Selector of a set allocated from the arena of the Scope where the Hasse
+  diagram is built (see arena::Allocator)
+*/
+struct arena_setS {};
+
+namespace boost {
+
+template <typename ValueType>
+struct container_gen<arena_listS, ValueType> {
+  typedef arena::List<ValueType> type;
+};
+
+template <typename ValueType>
+struct container_gen<arena_setS, ValueType> {
+  typedef std::set<ValueType, std::less<ValueType>,
+                   arena::Allocator<ValueType>>
+      type;
+};
+
+template <>
+struct parallel_edge_traits<arena_listS> {
+  typedef allow_parallel_edge_tag type;
+};
+
+template <>
+struct parallel_edge_traits<arena_setS> {
+  typedef disallow_parallel_edge_tag type;
+};
+
+};
+
 //=============================================================================
 // Typedefs used for readabily
 
@@ -77,13 +124,17 @@ struct HDGraphProperties {
 
 /**
   Hasse diagram
+
+  A Hasse diagram is a temporary of a level of the reduction: its containers
+  are allocated from the arena of the level, and freed together at its end.
 */
-typedef boost::adjacency_list<boost::setS,            // OutEdgeList
-                              boost::listS,            // VertexList
+typedef boost::adjacency_list<arena_setS,             // OutEdgeList
+                              arena_listS,            // VertexList
                               boost::bidirectionalS,  // Directed
                               HDVertexProperties,     // VertexProperties
                               HDEdgeProperties,       // EdgeProperties
-                              HDGraphProperties       // GraphProperties
+                              HDGraphProperties,      // GraphProperties
+                              arena_listS             // EdgeList
                               >
     HDGraph;
 
@@ -119,7 +170,7 @@ typedef boost::graph_traits<HDGraph>::out_edge_iterator HDOutEdgeIter;
 /**
   Iterator (const) of a list of signed characters
 */
-typedef std::list<SignedCharacter>::const_iterator SignedCharacterIter;
+typedef arena::List<SignedCharacter>::const_iterator SignedCharacterIter;
 
 // Size types
 
@@ -133,7 +184,7 @@ typedef boost::graph_traits<HDGraph>::vertices_size_type HDVertexSize;
 /**
   Map of vertex indexes (Hasse diagram)
 */
-typedef std::map<HDVertex, HDVertexSize> HDVertexIMap;
+typedef arena::Map<HDVertex, HDVertexSize> HDVertexIMap;
 
 /**
   Associative property map of vertex indexes (Hasse diagram)
@@ -169,7 +220,7 @@ inline std::ostream& operator<<(std::ostream& os, const State s) {
   @return Updated output stream
 */
 inline std::ostream& operator<<(std::ostream& os, const SignedCharacter sc) {
-  return os << sc.character << sc.state;
+  return os << get_name(sc.character, Type::character) << sc.state;
 }
 
 /**
@@ -190,29 +241,26 @@ inline bool operator==(const SignedCharacter& a, const SignedCharacter b) {
 /**
   @brief Add vertex with \e species and \e characters to \e hasse
 
-  @param[in]     species    List of species names
-  @param[in]     characters List of character names
+  @param[in]     species    List of species IDs
+  @param[in]     characters List of character IDs
   @param[in,out] hasse      Hasse diagram graph
 
   @return Vertex descriptor for the new vertex
 */
-HDVertex add_vertex(const std::list<std::string>& species,
-                    const std::list<std::string>& characters, HDGraph& hasse);
+HDVertex add_vertex(const std::list<size_t>& species,
+                    const std::list<size_t>& characters, HDGraph& hasse);
 
 /**
   @brief Add vertex with \e species and \e characters to \e hasse
 
-  @param[in]     species    Species name
-  @param[in]     characters List of character names
+  @param[in]     species    Species ID
+  @param[in]     characters List of character IDs
   @param[in,out] hasse      Hasse diagram graph
 
   @return Vertex descriptor for the new vertex
 */
-inline HDVertex add_vertex(const std::string& species,
-                           const std::list<std::string>& characters,
-                           HDGraph& hasse) {
-  return add_vertex(std::list<std::string>{species}, characters, hasse);
-}
+HDVertex add_vertex(const size_t species, const std::list<size_t>& characters,
+                    HDGraph& hasse);
 
 /**
   @brief Add edge between \e u and \e v with a list of signed characters to
@@ -254,7 +302,7 @@ inline const RBGraph* const orig_g(const HDGraph& hasse) {
 
   @return Pointer to the the original maximal reducible graph of \e hasse
 */
-inline const RBGraph* const orig_gm(const HDGraph& hasse) {
+inline RBGraph* const orig_gm(const HDGraph& hasse) {
   return hasse[boost::graph_bundle].gm;
 }
 
@@ -274,13 +322,12 @@ std::ostream& operator<<(std::ostream& os, const HDGraph& hasse);
 /**
   @brief Returns True if \e a is included in \e b
 
-  @param[in] a List of character names (strings)
-  @param[in] b List of character names (strings)
+  @param[in] a List of character IDs
+  @param[in] b List of character IDs
 
   @return True if \e a is included in \e b, False otherwise
 */
-bool is_included(const std::list<std::string>& a,
-                 const std::list<std::string>& b);
+bool is_included(const std::list<size_t>& a, const std::list<size_t>& b);
 
 /**
   @brief Build the Hasse diagram of \e gm
@@ -294,13 +341,17 @@ bool is_included(const std::list<std::string>& a,
   More precisely, two species s1 and s2 are connected by the arc (s1, s2) if
   s1 < s2 and there does not exist a species s3 such that s1 < s3 < s2.
 
+  The sets of characters are stored as bitsets: species with the same set are
+  merged with a hash lookup, and the arcs (the covering relation) are found
+  with subset tests against the vertices with less characters, so no
+  transitive reduction is needed.
+
   @param[out] hasse Hasse diagram graph
   @param[in]  g     Red-black graph
-  @param[in]  gm    Maximal reducible red-black graph
-  @param[in]  components Vector of red-black connected subgraphs
-  @param[in]  c_assocmap Connected Components map
+  @param[in]  gm    Maximal reducible red-black graph (chains and sources are
+                    tested on it and then rolled back)
 */
-void hasse_diagram(HDGraph& hasse, const RBGraph& g, const RBGraph& gm, const RBGraphVector& components, const RBVertexIMap& c_map);
+void hasse_diagram(HDGraph& hasse, const RBGraph& g, RBGraph& gm);
 
 /**
   @brief Removes active species from an hasse diagram
@@ -1,8 +1,23 @@
 #include <boost/program_options.hpp>
+#ifdef TESTPY
 #include <boost/python.hpp>
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "container.hpp"
 #include "hdgraph.hpp"
 #include "rbgraph.hpp"
 #include "functions.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+
+#ifdef TESTPY
+// check_reduction.py module
+boost::python::object pymod;
+#endif
 
 void conflicting_options(const boost::program_options::variables_map& vm,
                          const std::string& opt1, const std::string& opt2) {
@@ -13,10 +28,205 @@ void conflicting_options(const boost::program_options::variables_map& vm,
   }
 }
 
+/**
+  @brief Run the algorithm on the graph in \e instance, with the options in
+         \e vm
+
+  Logging output is written to logging::stream, so concurrent runs don't mix
+  their output.
+
+  @param[in] instance Instance
+  @param[in] vm       Options
+
+  @return Result line: Ok or No followed by (name of \e instance), and by the
+          reduction or the reason of the failure when logging is enabled.
+          With --stats, the result line is followed by the timers and the
+          counters of the run, as a JSON object on its own line.
+          With --trace, the run is recorded in trace::current as the run
+          trace::run
+*/
+std::string run_file(const Instance& instance,
+                     const boost::program_options::variables_map& vm) {
+  const auto& file = instance.name;
+  const bool check = vm["check"].as<bool>();
+  bool testpy = false;
+
+#ifdef TESTPY
+  testpy = vm["testpy"].as<bool>();
+#endif
+
+  std::stringstream result;
+  RBGraph g{};
+
+  // successful reductions counted by the exponential algorithm
+  std::atomic<size_t> count{0};
+  exponential::count = &count;
+
+  // timers and counters of the run
+  stats::Stats run_stats;
+  if (vm["stats"].as<bool>()) stats::current = &run_stats;
+
+  if (trace::current) {
+    // tracing enabled
+    trace::current->record(trace::Type::run_begin, trace::run, 0, file);
+  }
+
+  try {
+    if (!instance.error.empty()) throw std::runtime_error(instance.error);
+
+    {
+      const stats::Timer timer(stats::Stage::read_graph);
+
+      if (instance.contained)
+        read_graph(instance.data.data(), instance.data.size(), g);
+      else
+        read_graph(file, g);
+    }
+
+    std::list<size_t> keep_c{};
+
+    // bit-matrix of the input graph, used to check the reduction
+    RBMatrix m_check;
+    if (check) copy_graph(g, m_check);
+
+    if (vm["maximal"].as<bool>()) {
+      if (logging::enabled) {
+        // verbosity enabled
+        *logging::stream << "Graph G:" 
+                         << std::endl
+                         << g 
+                         << std::endl;
+      }
+      const auto gm = maximal_reducible_graph(g);
+
+      if (check || testpy) {
+        RBVertexIter v, v_end;
+        std::tie(v, v_end) = vertices(gm);
+        for (; v != v_end; ++v) {
+          if (!is_character(*v, gm)) continue;
+
+          keep_c.push_back(gm[*v].id);
+        }
+      }
+
+      g.clear();
+      copy_graph(gm, g);
+    }
+
+    std::list<SignedCharacter> output;
+
+    if (bitmatrix::enabled) {
+      // run the algorithm on the bit-matrix representation of g
+      RBMatrix m;
+      copy_graph(g, m);
+
+      output = reduce(m);
+    } else {
+      output = reduce(g);
+    }
+
+    std::stringstream reduction;
+    for (const auto& sc : output) {
+      reduction << sc << " ";
+    }
+
+    if (check) {
+      if (!check_reduction(m_check, output, keep_c))
+        // the reduction does not reduce the input graph to an empty graph
+        throw NoReduction();
+    }
+
+#ifdef TESTPY
+    if (testpy) {
+      if (instance.contained)
+        // check_reduction.py reads the input file by itself
+        throw std::runtime_error("Instances of containers can't be tested");
+
+      if (vm["maximal"].as<bool>()) {
+        std::stringstream keep_c_str;
+        for (const auto id : keep_c) {
+          keep_c_str << id << " ";
+        }
+
+        // run the function check_reduction(filename, reduction), store its
+        // output in pycheck
+        const auto pycheck = pymod.attr("check_reduction")(
+            file, reduction.str(), keep_c_str.str());
+
+        if (!boost::python::extract<bool>(pycheck)())
+          // check_reduction(filename, reduction) returned False
+          throw NoReduction();
+      } else {
+        // run the function check_reduction(filename, reduction), store its
+        // output in pycheck
+        const auto pycheck =
+            pymod.attr("check_reduction")(file, reduction.str());
+
+        if (!boost::python::extract<bool>(pycheck)())
+          // check_reduction(filename, reduction) returned False
+          throw NoReduction();
+      }
+    }
+#endif
+
+    result << "Ok (" << file << ")";
+
+    if (exponential::enabled &&
+        exponential::strategy == exponential::Strategy::count) {
+      // exponential algorithm enabled, counting the successful reductions
+      result << ": " << count << " successful reductions";
+    } else if (logging::enabled) {
+      // verbosity enabled
+      if (exponential::enabled) {
+        // exponential algorithm enabled
+        result << ": Successful reductions have been logged";
+      } else {
+        result << ": < " << reduction.str() << ">";
+      }
+    }
+#ifdef TESTPY
+  } catch (const boost::python::error_already_set& e) {
+    result << "No (" << file << ")";
+
+    if (logging::enabled) {
+      // verbosity enabled
+      result << ": Python error";
+    }
+#endif
+  } catch (const std::exception& e) {
+    result << "No (" << file << ")";
+
+    if (logging::enabled) {
+      // verbosity enabled
+      result << ": " << e.what();
+    }
+  }
+
+  exponential::count = nullptr;
+
+  if (trace::current) {
+    // tracing enabled
+    trace::record(trace::Type::run_end, trace::run,
+                  result.str().compare(0, 2, "Ok") == 0);
+  }
+
+  if (stats::current) {
+    // statistics enabled
+    result << std::endl << stats::to_json(run_stats, file);
+
+    stats::current = nullptr;
+  }
+
+  return result.str();
+}
+
 int main(int argc, const char* argv[]) {
  // declare the vector of input files
   std::vector<std::string> files;
 
+  // range of instances to run the algorithm on
+  size_t range_first = 0, range_last = SIZE_MAX;
+
   // initialize options menu
   boost::program_options::options_description general_options(
       "Usage: ppp [OPTION...] FILE..."
@@ -33,34 +243,93 @@ int main(int argc, const char* argv[]) {
       // option: verbose, print information on the ongoing operations
       ("verbose,v", boost::program_options::bool_switch(&logging::enabled),
        "Display the operations performed by the program.\n")
+      // option: check, test reduce output with the reduction verifier
+      ("check,c", boost::program_options::bool_switch()->default_value(false),
+       "Test the output of the algorithm with the reduction verifier.\n")
+#ifdef TESTPY
       // option: testpy, test reduce output with a python script
       ("testpy,t", boost::program_options::bool_switch()->default_value(false),
        "Test the output of the algorithm with check_reduction.py.\n")
+#endif
       // option: exponential, test every possible combination of safe sources
       ("exponential,x",
        boost::program_options::bool_switch(&exponential::enabled),
        "Exponential version of the algorithm.\n"
        "(Mutually exclusive with --interactive)\n"
        "(Mutually exclusive with --nthsource)\n")
+      // option: strategy, what the exponential algorithm does with the
+      // successful reductions
+      ("strategy,s",
+       boost::program_options::value<std::string>()->default_value("all"),
+       "Strategy of the exponential algorithm: all (keep every successful "
+       "reduction), first (stop at the first one), count (count them) or "
+       "stream (write each one as soon as it's found).\n")
       // option: interactive, let the user select which path to take
       ("interactive,i",
        boost::program_options::bool_switch(&interactive::enabled),
        "User input driven execution.\n"
        "(Mutually exclusive with --exponential)\n"
-       "(Mutually exclusive with --nthsource)\n")
+       "(Mutually exclusive with --nthsource)\n"
+       "(Mutually exclusive with --jobs)\n")
       // option: maximal, read graph and reduce it to maximal
       ("maximal,m", boost::program_options::bool_switch()->default_value(false),
        "Run the algorithm on the maximal subgraph.\n")
       // option: active, include active characters during hasse diagram construction
       ("active,a", boost::program_options::bool_switch(&active::enabled),
        "Hasse diagram with active characters.\n")
+      // option: bitmatrix, run the algorithm on the bit-matrix representation
+      ("bitmatrix,b",
+       boost::program_options::bool_switch(&bitmatrix::enabled)
+           ->default_value(bitmatrix::enabled),
+       "Run the algorithm on the bit-matrix representation of the graph.\n")
       // option: help message
       ("nthsource,n",
        boost::program_options::value<size_t>(&nthsource::index)
            ->default_value(0),
        "Select the nth safe source when possible.\n"
        "(Mutually exclusive with --exponential)\n"
-       "(Mutually exclusive with --interactive)\n");
+       "(Mutually exclusive with --interactive)\n")
+      // option: threads, number of threads reducing components in parallel
+      ("threads,p",
+       boost::program_options::value<size_t>(&parallel::threads)
+           ->default_value(1),
+       "Reduce the connected components of a graph on N threads.\n")
+      // option: grain, minimum size of a component reduced in parallel
+      ("grain,g",
+       boost::program_options::value<size_t>(&parallel::grain)
+           ->default_value(parallel::grain),
+       "Reduce components with less than N vertices on the calling thread "
+       "when running on more threads.\n")
+      // option: memo, memory budget of the reduction memo
+      ("memo",
+       boost::program_options::value<size_t>()->default_value(
+           memo::budget >> 20),
+       "Memory budget (in MiB) of the memo of the reductions found by the "
+       "exponential algorithm (0 disables it).\n")
+      // option: jobs, number of files processed in parallel
+      ("jobs,j",
+       boost::program_options::value<size_t>()->default_value(1),
+       "Run the algorithm on N files in parallel (0 for one file for each "
+       "hardware thread).\n"
+       "(Mutually exclusive with --interactive)\n")
+      // option: range, instances to run the algorithm on
+      ("range,r", boost::program_options::value<std::string>(),
+       "Run the algorithm only on the instances from FIRST to LAST - 1, as "
+       "FIRST:LAST (either can be omitted), counting the instances of the "
+       "containers in FILE(s) one by one.\n")
+      // option: prefetch, instances of containers read ahead
+      ("prefetch",
+       boost::program_options::value<size_t>()->default_value(0),
+       "Read up to N instances of the containers ahead, on a background "
+       "thread.\n")
+      // option: stats, timers and counters of each run
+      ("stats", boost::program_options::bool_switch()->default_value(false),
+       "Write, after the result of each file, the time taken by each stage "
+       "of the algorithm and the counters of the reduction, as JSON.\n")
+      // option: trace, binary trace of the reductions
+      ("trace", boost::program_options::value<std::string>(),
+       "Write a binary trace of the reductions to FILE, to be read with "
+       "ppp-decode.\n");
 
   // initialize hidden options (not shown in --help)
   boost::program_options::options_description hidden_options;
@@ -96,7 +365,47 @@ int main(int argc, const char* argv[]) {
     conflicting_options(vm, "nthsource", "exponential");
     conflicting_options(vm, "nthsource", "interactive");
 
+    conflicting_options(vm, "jobs", "interactive");
+#ifdef TESTPY
+    conflicting_options(vm, "jobs", "testpy");
+#endif
+
     boost::program_options::notify(vm);
+
+#if LOG_LEVEL < 1
+    if (logging::enabled)
+      // logging statements removed at compile time (make release)
+      throw std::logic_error("Verbose output is not available in this build");
+#endif
+
+    const auto strategy = vm["strategy"].as<std::string>();
+
+    if (strategy == "all") {
+      exponential::strategy = exponential::Strategy::all;
+    } else if (strategy == "first") {
+      exponential::strategy = exponential::Strategy::first;
+    } else if (strategy == "count") {
+      exponential::strategy = exponential::Strategy::count;
+    } else if (strategy == "stream") {
+      exponential::strategy = exponential::Strategy::stream;
+    } else {
+      throw boost::program_options::invalid_option_value(strategy);
+    }
+
+    if (vm.count("range")) {
+      // FIRST:LAST, FIRST: or :LAST
+      const auto range = vm["range"].as<std::string>();
+      const auto colon = range.find(':');
+
+      if (colon == std::string::npos ||
+          range.find_first_not_of("0123456789:") != std::string::npos ||
+          range.find(':', colon + 1) != std::string::npos)
+        throw boost::program_options::invalid_option_value(range);
+
+      if (colon > 0) range_first = std::stoull(range.substr(0, colon));
+      if (colon + 1 < range.size())
+        range_last = std::stoull(range.substr(colon + 1));
+    }
   } catch (const std::exception& e) {
     // error while parsing the options given in input
     std::cerr << "Error: " << e.what() << "." << std::endl
@@ -106,6 +415,8 @@ int main(int argc, const char* argv[]) {
     return 1;
   }
 
+  memo::budget = vm["memo"].as<size_t>() << 20;
+
   if (vm.count("help")) {
     // help option specified
     std::cerr << general_options << std::endl;
@@ -122,13 +433,45 @@ int main(int argc, const char* argv[]) {
     return 1;
   }
 
-  if (files.size() > 1) {
-    std::cout << "Running PPP on " << files.size() << " files." << std::endl
-              << std::endl;
+  // instances of the input files, counting the ones of each container
+  std::unique_ptr<InstanceReader> reader;
+
+  try {
+    reader.reset(new InstanceReader(files, range_first, range_last,
+                                    vm["prefetch"].as<size_t>()));
+  } catch (const std::exception& e) {
+    // error while reading a container
+    std::cerr << "Error: " << e.what() << "." << std::endl;
+
+    return 1;
   }
 
-  boost::python::object pymod;
+  const auto n_instances = reader->size();
+
+  // binary trace of the runs, shared by all the threads
+  std::unique_ptr<trace::Trace> run_trace;
+
+  if (vm.count("trace")) {
+    try {
+      run_trace.reset(new trace::Trace(vm["trace"].as<std::string>()));
+    } catch (const std::exception& e) {
+      // error while opening the trace file
+      std::cerr << "Error: " << e.what() << "." << std::endl;
+
+      return 1;
+    }
+
+    trace::current = run_trace.get();
+  }
 
+  if (n_instances > 1) {
+    std::cout << "Running PPP on " << n_instances
+              << (reader->has_containers() ? " instances." : " files.")
+              << std::endl
+              << std::endl;
+  }
+
+#ifdef TESTPY
   if (vm["testpy"].as<bool>()) {
     // initialize the python interpreter
     setenv("PYTHONPATH", "bin", 1);
@@ -137,137 +480,164 @@ int main(int argc, const char* argv[]) {
     // import check_reduction.py
     pymod = boost::python::import("check_reduction");
   }
+#endif
+
+  // number of worker threads, 0 means one for each hardware thread
+  auto n_jobs = vm["jobs"].as<size_t>();
+  if (n_jobs == 0) n_jobs = std::thread::hardware_concurrency();
+  n_jobs = std::max<size_t>(1, std::min(n_jobs, n_instances));
+
+  // the logging output, or the reductions streamed by the exponential
+  // algorithm, are written between the result lines
+  const bool log_output =
+      logging::enabled ||
+      (exponential::enabled &&
+       exponential::strategy == exponential::Strategy::stream);
+
+  if (n_jobs == 1) {
+    size_t count_file = 0;
+    Instance instance;
+    while (reader->next(instance)) {
+      // for each instance
+      const auto& file = instance.name;
+
+      if (log_output) {
+        // logging output enabled
+        std::cout << "F  (" << file << ")" << std::endl;
+      } else {
+        // verbosity disabled
+        if (n_instances > 1) {
+          const auto d_perc = std::floor(100.0 * count_file / n_instances);
+          const auto perc = static_cast<size_t>(d_perc);
 
-  size_t count_file = 0;
-  for (const auto& file : files) {
-    // for each filename in files
+          if (perc < 10) std::cout << " ";
 
-    if (logging::enabled) {
-      // verbosity enabled
-      std::cout << "F  (" << file << ")" << std::endl;
-    } else {
-      // verbosity disabled
-      if (files.size() > 1) {
-        const auto d_perc = std::floor(100.0 * count_file / files.size());
-        const auto perc = static_cast<size_t>(d_perc);
+          std::cout << "\033[32m" << perc << "\033[39m (" << file << ")"
+                    << std::flush;
+        } else {
+          std::cout << "F  (" << file << ")" << std::flush;
+        }
+      }
 
-        if (perc < 10) std::cout << " ";
+      trace::run = count_file++;
 
-        std::cout << "\033[32m" << perc << "\033[39m (" << file << ")"
-                  << std::flush;
-      } else {
-        std::cout << "F  (" << file << ")" << std::flush;
+      const auto result = run_file(instance, vm);
+
+      if (!log_output) {
+        // logging output disabled
+        std::cout << '\r';
       }
+
+      std::cout << result << std::endl;
     }
 
-    count_file++;
+    return 0;
+  }
 
-    RBGraph g{};
+  // batch mode: the instances are shared among n_jobs worker threads, each
+  // one with its own copy of the options, while the main thread writes the
+  // results (and the logs) in input order
+  const auto config = save_config();
 
-    try {
-      read_graph(file, g);
-      std::stringstream keep_c{};
+  std::vector<std::string> logs(n_instances), results(n_instances);
+  std::vector<bool> done(n_instances, false);
+  size_t count_done = 0;
 
-      if (vm["maximal"].as<bool>()) {
-        if (logging::enabled) {
-          // verbosity enabled
-          std::cout << "Graph G:" 
-                << std::endl
-                << g 
-                << std::endl;
-        }
-        const auto gm = maximal_reducible_graph(g);
+  size_t next_file = 0;
+  std::mutex reader_mutex, mutex;
+  std::condition_variable file_done;
 
-        if (vm["testpy"].as<bool>()) {
-          RBVertexIter v, v_end;
-          std::tie(v, v_end) = vertices(gm);
-          for (; v != v_end; ++v) {
-            if (!is_character(*v, gm)) continue;
+  const auto worker = [&]() {
+    load_config(config);
 
-            keep_c << g[*v].name.substr(1) << " ";
-          }
-        }
+    std::stringstream log;
+    logging::stream = &log;
 
-        g.clear();
-        copy_graph(gm, g);
-      }
+    Instance instance;
 
-      const auto output = reduce(g);
+    while (true) {
+      // for each instance not yet taken by a worker
+      size_t i;
 
-      std::stringstream reduction;
-      for (const auto& sc : output) {
-        reduction << sc << " ";
-      }
+      {
+        std::lock_guard<std::mutex> lock(reader_mutex);
 
-      if (vm["testpy"].as<bool>()) {
-        if (vm["maximal"].as<bool>()) {
-          // run the function check_reduction(filename, reduction), store its
-          // output in pycheck
-          const auto pycheck = pymod.attr("check_reduction")(
-              file, reduction.str(), keep_c.str());
+        if (!reader->next(instance)) break;
 
-          if (!boost::python::extract<bool>(pycheck)())
-            // check_reduction(filename, reduction) returned False
-            throw NoReduction();
-        } else {
-          // run the function check_reduction(filename, reduction), store its
-          // output in pycheck
-          const auto pycheck =
-              pymod.attr("check_reduction")(file, reduction.str());
-
-          if (!boost::python::extract<bool>(pycheck)())
-            // check_reduction(filename, reduction) returned False
-            throw NoReduction();
-        }
+        i = next_file++;
       }
 
-      if (!logging::enabled) {
-        // verbosity disabled
-        std::cout << '\r';
+      log.str("");
+      trace::run = i;
+
+      if (log_output) {
+        // logging output enabled
+        log << "F  (" << instance.name << ")" << std::endl;
       }
 
-      std::cout << "Ok (" << file << ")";
+      auto result = run_file(instance, vm);
 
-      if (logging::enabled) {
-        // verbosity enabled
-        if (exponential::enabled) {
-          // exponential algorithm enabled
-          std::cout << ": Successful reductions have been logged";
-        } else {
-          std::cout << ": < " << reduction.str() << ">";
-        }
-      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
 
-      std::cout << std::endl;
-    } catch (const boost::python::error_already_set& e) {
-      if (!logging::enabled) {
-        // verbosity disabled
-        std::cout << '\r';
+        logs[i] = log.str();
+        results[i] = std::move(result);
+        done[i] = true;
+        count_done++;
       }
 
-      std::cout << "No (" << file << ")";
+      file_done.notify_one();
+    }
+  };
 
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << ": Python error";
-      }
+  std::vector<std::thread> workers;
+  for (size_t j = 0; j < n_jobs; ++j) {
+    workers.emplace_back(worker);
+  }
 
-      std::cout << std::endl;
-    } catch (const std::exception& e) {
-      if (!logging::enabled) {
-        // verbosity disabled
-        std::cout << '\r';
-      }
+  if (!log_output) {
+    // logging output disabled
+    std::cout << " \033[32m0\033[39m (" << reader->name(0) << ")"
+              << std::flush;
+  }
 
-      std::cout << "No (" << file << ")";
+  for (size_t i = 0; i < n_instances; ++i) {
+    // for each instance, wait for its result
+    std::string log, result;
+    size_t perc = 0;
 
-      if (logging::enabled) {
-        // verbosity enabled
-        std::cout << ": " << e.what();
-      }
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      file_done.wait(lock, [&]() { return done[i]; });
+
+      log = std::move(logs[i]);
+      result = std::move(results[i]);
 
-      std::cout << std::endl;
+      const auto d_perc = std::floor(100.0 * count_done / n_instances);
+      perc = static_cast<size_t>(d_perc);
     }
+
+    if (log_output) {
+      // logging output enabled
+      std::cout << log << result << std::endl;
+
+      continue;
+    }
+
+    // logging output disabled
+    std::cout << '\r' << result << std::endl;
+
+    if (i + 1 < n_instances) {
+      // show the progress of all workers next to the first pending file
+      if (perc < 10) std::cout << " ";
+
+      std::cout << "\033[32m" << perc << "\033[39m (" << reader->name(i + 1)
+                << ")" << std::flush;
+    }
+  }
+
+  for (auto& worker_thread : workers) {
+    worker_thread.join();
   }
 
   return 0;
@@ -1,8 +1,772 @@
 #include "rbgraph.hpp"
-#include <boost/graph/connected_components.hpp>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/graph_utility.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
 #include <fstream>
+#include <mutex>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include "stats.hpp"
+
+//=============================================================================
+// Vertex names
+
+/**
+  @brief Struct used to intern the vertex names of one type
+
+  Names are stored in a deque, so the references returned by get_name stay
+  valid while other names are interned.
+*/
+struct RBNameTable {
+  std::deque<std::string> names{};                ///< Name of each ID
+  std::deque<size_t> indices{};                   ///< Index of each ID
+  std::unordered_map<std::string, size_t> ids{};  ///< ID of each name
+};
+
+static RBNameTable species_names, character_names;
+
+// the name tables are shared by all threads
+static std::mutex names_mutex;
+
+/**
+  @brief Return the name table of the vertices of type \e type
+
+  @param[in] type Type
+
+  @return Name table
+*/
+static inline RBNameTable& name_table(const Type type) {
+  if (type == Type::species) return species_names;
+
+  return character_names;
+}
+
+/**
+  @brief Return the index of \e name, that is the number after its first
+         character (e.g. 12 for s12), or 0 if there is none
+
+  Vertices are printed sorted by index (see print_adjacency).
+
+  @param[in] name Vertex name
+
+  @return Index
+*/
+static size_t name_index(const std::string& name) {
+  if (name.size() < 2) return 0;
+
+  // same result as reading the number with an input stream
+  return std::strtoull(name.c_str() + 1, nullptr, 10);
+}
+
+size_t intern_name(const std::string& name, const Type type) {
+  std::lock_guard<std::mutex> lock(names_mutex);
+
+  auto& table = name_table(type);
+
+  const auto id = table.ids.emplace(name, table.names.size());
+
+  // name is new, its ID is the next one
+  if (id.second) {
+    table.names.push_back(name);
+    table.indices.push_back(name_index(name));
+  }
+
+  return id.first->second;
+}
+
+const std::string& get_name(const size_t id, const Type type) {
+  std::lock_guard<std::mutex> lock(names_mutex);
+
+  return name_table(type).names.at(id);
+}
+
+//=============================================================================
+// Connected components tracking
+
+/**
+  @brief Return the component label of \e v in \e g
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+
+  @return Reference to the component label of \e v
+*/
+static inline size_t& label(const RBVertex v, const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+
+  if (is_species(v, g)) return comps.species[g[v].id];
+
+  return comps.characters[g[v].id];
+}
+
+/**
+  @brief Mark the component of \e v as dirty in \e g, \e v will be one of
+         the vertices the component is labeled again from
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+*/
+static void touch_component(const RBVertex v, const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+
+  if (!comps.valid) return;
+
+  const auto c = label(v, g);
+
+  if (!comps.dirty[c]) {
+    comps.dirty[c] = true;
+    comps.dirty_list.push_back(c);
+  }
+
+  comps.seeds.emplace_back(g[v].type, g[v].id);
+}
+
+/**
+  @brief Add a new component to \e comps
+
+  @param[in]     first First vertex (type, ID) of the component
+  @param[in,out] comps Connected components
+
+  @return Label of the new component
+*/
+static size_t new_component(const std::pair<Type, size_t>& first,
+                            RBComponents& comps) {
+  comps.num_species.push_back(0);
+  comps.first.push_back(first);
+  comps.alive.push_back(true);
+  comps.dirty.push_back(false);
+  comps.count++;
+
+  return comps.alive.size() - 1;
+}
+
+/**
+  @brief Label the component of \e v in \e g as \e c, visiting it from \e v
+
+  @param[in] v Vertex
+  @param[in] c Component label
+  @param[in] g Red-black graph
+*/
+static void label_component(const RBVertex v, const size_t c,
+                            const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+  std::vector<RBVertex> stack{v};
+
+  label(v, g) = c;
+
+  while (!stack.empty()) {
+    const auto u = stack.back();
+    stack.pop_back();
+
+    const std::pair<Type, size_t> u_key(g[u].type, g[u].id);
+
+    if (is_species(u, g)) comps.num_species[c]++;
+    if (u_key < comps.first[c]) comps.first[c] = u_key;
+
+    RBOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(u, g);
+    for (; e != e_end; ++e) {
+      const auto vt = target(*e, g);
+
+      if (label(vt, g) == c) continue;
+
+      label(vt, g) = c;
+      stack.push_back(vt);
+    }
+  }
+}
+
+/**
+  @brief Add the component of the singleton \e v to the components of \e g
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+*/
+static void add_singleton_component(const RBVertex v, const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+
+  if (!comps.valid) return;
+
+  // v is a new component on its own
+  auto& labels = (is_species(v, g) ? comps.species : comps.characters);
+
+  if (g[v].id >= labels.size()) labels.resize(g[v].id + 1, SIZE_MAX);
+
+  labels[g[v].id] = new_component({g[v].type, g[v].id}, comps);
+
+  if (is_species(v, g)) comps.num_species[labels[g[v].id]]++;
+}
+
+/**
+  @brief Remove the component of the singleton \e v from the components of
+         \e g
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+*/
+static void remove_singleton_component(const RBVertex v, const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+
+  if (comps.valid && !comps.dirty[label(v, g)]) {
+    // v has no edges, so it's the only vertex in its component
+    comps.alive[label(v, g)] = false;
+    comps.count--;
+  }
+}
+
+/**
+  @brief Bring the connected components of \e g up to date
+
+  @param[in] g Red-black graph
+*/
+static void update_components(const RBGraph& g) {
+  auto& comps = g[boost::graph_bundle].components;
+
+  if (comps.valid && comps.dirty_list.empty()) return;
+
+  if (!comps.valid) {
+    // label every vertex of g, in order
+    comps = RBComponents{};
+    comps.species.assign(vertex_map(Type::species, g).size(), SIZE_MAX);
+    comps.characters.assign(vertex_map(Type::character, g).size(), SIZE_MAX);
+
+    RBVertexIter v, v_end;
+    std::tie(v, v_end) = vertices(g);
+    for (; v != v_end; ++v) {
+      if (label(*v, g) != SIZE_MAX) continue;
+
+      const auto c = new_component({g[*v].type, g[*v].id}, comps);
+      label_component(*v, c, g);
+    }
+
+    comps.valid = true;
+
+    return;
+  }
+
+  // the dirty components are split (or merged) into new components
+  for (const auto c : comps.dirty_list) {
+    if (!comps.alive[c]) continue;
+
+    comps.alive[c] = false;
+    comps.count--;
+  }
+
+  for (const auto& seed : comps.seeds) {
+    const auto& v_map = vertex_map(seed.first, g);
+
+    if (seed.second >= v_map.size() ||
+        v_map[seed.second] == RBGraph::null_vertex())
+      // the vertex has been removed
+      continue;
+
+    const auto v = v_map[seed.second];
+
+    if (!comps.dirty[label(v, g)])
+      // the vertex has already been labeled again
+      continue;
+
+    const auto c = new_component(seed, comps);
+    label_component(v, c, g);
+  }
+
+  for (const auto c : comps.dirty_list) {
+    comps.dirty[c] = false;
+  }
+
+  comps.dirty_list.clear();
+  comps.seeds.clear();
+}
+
+/**
+  @brief Copy the edge counters of the vertices of \e g to \e g_copy
+
+  boost::copy_graph adds the edges of the copy with the add_edge overload of
+  RBGraph after copying the vertex properties, so the counters are restored
+  once the copy is complete. Both graphs have their vertices in the same order.
+
+  @param[in]     g      Red-black graph
+  @param[in,out] g_copy Copy of \e g
+*/
+static void copy_degrees(const RBGraph& g, RBGraph& g_copy) {
+  RBVertexIter u, u_end, v;
+  std::tie(u, u_end) = vertices(g);
+  v = vertices(g_copy).first;
+  for (; u != u_end; ++u, ++v) {
+    g_copy[*v].red_degree = g[*u].red_degree;
+    g_copy[*v].black_degree = g[*u].black_degree;
+  }
+}
+
+//=============================================================================
+// Red Σ-graphs tracking
+
+/**
+  @brief Mark the character \e c as dirty in \e g, so that its pairs are
+         checked again by the next query
+
+  @param[in] c Character vertex
+  @param[in] g Red-black graph
+*/
+static void touch_sigma_character(const RBVertex c, const RBGraph& g) {
+  auto& sigma = g[boost::graph_bundle].sigma;
+
+  if (g[c].id >= sigma.n_characters) {
+    // c wasn't in g when the counters were built
+    sigma.valid = false;
+
+    return;
+  }
+
+  if (!sigma.dirty[g[c].id]) {
+    sigma.dirty[g[c].id] = true;
+    sigma.dirty_list.push_back(g[c].id);
+  }
+}
+
+/**
+  @brief Add (or remove) the species \e s to the species shared by the
+         character \e c and each character incident on a red edge of \e s
+
+  The red edge between \e s and \e c, if it exists, is ignored.
+
+  @param[in] s     Species vertex
+  @param[in] c     Character vertex
+  @param[in] added True if \e s is added, false if it's removed
+  @param[in] g     Red-black graph
+*/
+static void update_shared(const RBVertex s, const RBVertex c, const bool added,
+                          const RBGraph& g) {
+  auto& sigma = g[boost::graph_bundle].sigma;
+  const auto n = sigma.n_characters;
+  const auto c0 = g[c].id;
+
+  RBOutEdgeIter e, e_end;
+  std::tie(e, e_end) = out_edges(s, g);
+  for (; e != e_end; ++e) {
+    const auto v = target(*e, g);
+
+    if (v == c || !is_red(*e, g)) continue;
+
+    // for each other character incident on a red edge of s
+    const auto c1 = g[v].id;
+
+    if (c1 >= n) continue;
+
+    if (added) {
+      sigma.shared[c0 * n + c1]++;
+      sigma.shared[c1 * n + c0]++;
+    } else {
+      sigma.shared[c0 * n + c1]--;
+      sigma.shared[c1 * n + c0]--;
+    }
+  }
+}
+
+/**
+  @brief Update the red Σ-graphs of \e g after an edge between \e u and \e v
+         has been added or removed
+
+  @param[in] u     Vertex
+  @param[in] v     Vertex
+  @param[in] color Color of the edge
+  @param[in] added True if the edge has been added, false if it has been
+                   removed
+  @param[in] g     Red-black graph
+*/
+static void touch_sigma(const RBVertex u, const RBVertex v, const Color color,
+                        const bool added, const RBGraph& g) {
+  if (!g[boost::graph_bundle].sigma.valid) return;
+
+  const auto s = (is_species(u, g) ? u : v);
+  const auto c = (is_species(u, g) ? v : u);
+
+  // the red degree of c, or whether c is active, may have changed
+  touch_sigma_character(c, g);
+
+  if (color == Color::red && g[boost::graph_bundle].sigma.valid)
+    update_shared(s, c, added, g);
+}
+
+/**
+  @brief Check again the pairs of the character \e c0 in the red Σ-graphs
+         of \e g
+
+  @param[in] c0 Character ID
+  @param[in] g  Red-black graph
+*/
+static void update_sigma_pairs(const size_t c0, const RBGraph& g) {
+  auto& sigma = g[boost::graph_bundle].sigma;
+  const auto n = sigma.n_characters;
+  const auto& c_map = vertex_map(Type::character, g);
+
+  const auto v0 = c_map[c0];
+  const bool active0 = (v0 != RBGraph::null_vertex() && is_active(v0, g));
+
+  for (size_t c1 = 0; c1 < n; ++c1) {
+    const auto n_shared = sigma.shared[c0 * n + c1];
+    const auto key = std::min(c0, c1) * n + std::max(c0, c1);
+
+    // c0 and c1 induce a red Σ-graph if they're both active and each one
+    // has a red edge to a species not shared with the other
+    bool in_sigma = false;
+
+    if (n_shared > 0 && active0) {
+      const auto v1 = c_map[c1];
+
+      in_sigma = (is_active(v1, g) && n_shared < red_degree(v0, g) &&
+                  n_shared < red_degree(v1, g));
+    }
+
+    if (in_sigma == sigma.pairs[key]) continue;
+
+    sigma.pairs[key] = in_sigma;
+
+    if (in_sigma)
+      sigma.count++;
+    else
+      sigma.count--;
+  }
+}
+
+/**
+  @brief Bring the red Σ-graphs of \e g up to date
+
+  The counters are built the first time, then only the pairs of the
+  characters whose edges changed since the last query are checked again.
+
+  @param[in] g Red-black graph
+*/
+static void update_sigma(const RBGraph& g) {
+  auto& sigma = g[boost::graph_bundle].sigma;
+
+  if (!sigma.valid) {
+    const auto n = vertex_map(Type::character, g).size();
+
+    sigma = RBSigma{};
+    sigma.n_characters = n;
+    sigma.shared.assign(n * n, 0);
+    sigma.pairs.assign(n * n, false);
+    sigma.dirty.assign(n, false);
+
+    std::vector<size_t> red_characters;
+
+    RBVertexIter v, v_end;
+    std::tie(v, v_end) = vertices(g);
+    for (; v != v_end; ++v) {
+      if (!is_species(*v, g)) continue;
+
+      // for each species, each pair of characters incident on its red edges
+      // shares it
+      red_characters.clear();
+
+      RBOutEdgeIter e, e_end;
+      std::tie(e, e_end) = out_edges(*v, g);
+      for (; e != e_end; ++e) {
+        if (is_red(*e, g)) red_characters.push_back(g[target(*e, g)].id);
+      }
+
+      for (const auto c0 : red_characters) {
+        for (const auto c1 : red_characters) {
+          if (c0 != c1) sigma.shared[c0 * n + c1]++;
+        }
+      }
+    }
+
+    for (size_t c = 0; c < n; ++c) {
+      sigma.dirty_list.push_back(c);
+    }
+
+    sigma.valid = true;
+  }
+
+  for (const auto c : sigma.dirty_list) {
+    sigma.dirty[c] = false;
+
+    update_sigma_pairs(c, g);
+  }
+
+  sigma.dirty_list.clear();
+}
+
+//=============================================================================
+// Undo journal
+
+/**
+  List of vertices of a red-black graph, as stored by Boost
+*/
+typedef std::remove_reference<decltype(
+    std::declval<RBGraph&>().vertex_set())>::type RBStoredVertexList;
+
+/**
+  List of edges incident on a vertex of a red-black graph, as stored by Boost
+*/
+typedef std::remove_reference<decltype(
+    std::declval<RBGraph&>().out_edge_list(RBVertex()))>::type
+    RBStoredOutEdgeList;
+
+/**
+  List of the edges of a red-black graph (with their properties), as stored by
+  Boost
+*/
+typedef RBGraph::EdgeContainer RBStoredEdgeList;
+
+/**
+  @brief Struct used to represent a change recorded in the undo journal
+
+  Removed vertices and edges are not deleted: their nodes are moved (spliced)
+  from the lists of the graph to the lists of the journal, along with the
+  position of the node that followed them, and moved back on rollback.
+*/
+struct RBChange {
+  /**
+    Scoped enumeration type used for the kind of change
+  */
+  enum class Kind {
+    add_vertex,       ///< Vertex added
+    remove_vertex,    ///< Vertex removed
+    add_edge,         ///< Edge added
+    remove_edge,      ///< Edge removed
+    change_char_type  ///< Colors of the edges of a character flipped
+  };
+
+  Kind kind{};    ///< Kind of change
+  RBVertex v{};   ///< Vertex (source of the edge for edge changes)
+  RBVertex u{};   ///< Target of the edge (removed edges)
+  RBEdge e{};     ///< Edge (added edges)
+
+  RBStoredVertexList::iterator vertex{};  ///< Node of the removed vertex
+  RBStoredVertexList::iterator vertex_next{};  ///< Node that followed it
+
+  RBStoredEdgeList::iterator edge{};       ///< Node of the removed edge
+  RBStoredEdgeList::iterator edge_next{};  ///< Node that followed it
+
+  RBStoredOutEdgeList::iterator v_edge{};       ///< Node of the removed edge in
+                                                ///< the edges of v
+  RBStoredOutEdgeList::iterator v_edge_next{};  ///< Node that followed it
+  RBStoredOutEdgeList::iterator u_edge{};       ///< Node of the removed edge in
+                                                ///< the edges of u
+  RBStoredOutEdgeList::iterator u_edge_next{};  ///< Node that followed it
+};
+
+/**
+  @brief Struct used to represent the undo journal of a red-black graph
+*/
+struct RBJournal {
+  std::vector<RBChange> changes{};     ///< Changes, in order
+  std::vector<size_t> checkpoints{};  ///< Number of changes at each
+                                      ///< checkpoint
+  bool replaying{};  ///< True while the changes are being undone
+
+  RBStoredVertexList vertices{};    ///< Removed vertices
+  RBStoredEdgeList edges{};         ///< Removed edges
+  RBStoredOutEdgeList out_edges{};  ///< Removed edges (incidence lists)
+
+  ~RBJournal() {
+    // removed vertices are owned by the journal until they are put back
+    for (const auto v : vertices) {
+      delete static_cast<RBGraph::stored_vertex*>(v);
+    }
+  }
+};
+
+RBJournalHolder::RBJournalHolder() = default;
+
+RBJournalHolder::RBJournalHolder(const RBJournalHolder&) {}
+
+RBJournalHolder& RBJournalHolder::operator=(const RBJournalHolder&) {
+  journal.reset();
+
+  return *this;
+}
+
+RBJournalHolder::~RBJournalHolder() = default;
+
+/**
+  @brief Return the journal of \e g if its changes are being recorded
+
+  @param[in] g Red-black graph
+
+  @return Pointer to the journal, or nullptr
+*/
+static inline RBJournal* recording(RBGraph& g) {
+  auto* const journal = g[boost::graph_bundle].journal.journal.get();
+
+  if (journal == nullptr || journal->checkpoints.empty() || journal->replaying)
+    return nullptr;
+
+  return journal;
+}
+
+/**
+  @brief Move the vertex \e v out of \e g into \e journal
+
+  @param[in]     v       Vertex
+  @param[in,out] g       Red-black graph
+  @param[in,out] journal Undo journal of \e g
+*/
+static void detach_vertex(const RBVertex v, RBGraph& g, RBJournal& journal) {
+  auto& stored_v = *static_cast<RBGraph::stored_vertex*>(v);
+
+  RBChange change{RBChange::Kind::remove_vertex, v};
+  change.vertex = stored_v.m_position;
+  change.vertex_next = std::next(change.vertex);
+
+  journal.vertices.splice(journal.vertices.end(), g.vertex_set(),
+                          change.vertex);
+  journal.changes.push_back(change);
+}
+
+/**
+  @brief Return the node of \e e in the incidence list \e edges
+
+  @param[in] e     Edge
+  @param[in] edges Incidence list of one of the vertices of \e e
+
+  @return Node of \e e
+*/
+static RBStoredOutEdgeList::iterator find_edge(const RBEdge e,
+                                              RBStoredOutEdgeList& edges) {
+  return std::find_if(edges.begin(), edges.end(), [&](const auto& stored_e) {
+    return (&stored_e.get_property() == e.get_property());
+  });
+}
+
+/**
+  @brief Move the edge \e e out of \e g into \e journal
+
+  @param[in]     e       Edge
+  @param[in,out] g       Red-black graph
+  @param[in,out] journal Undo journal of \e g
+*/
+static void detach_edge(const RBEdge e, RBGraph& g, RBJournal& journal) {
+  RBChange change{RBChange::Kind::remove_edge, source(e, g)};
+  change.u = target(e, g);
+
+  auto& v_edges = g.out_edge_list(change.v);
+  auto& u_edges = g.out_edge_list(change.u);
+
+  change.v_edge = find_edge(e, v_edges);
+  change.v_edge_next = std::next(change.v_edge);
+  change.u_edge = find_edge(e, u_edges);
+  change.u_edge_next = std::next(change.u_edge);
+  change.edge = change.v_edge->get_iter();
+  change.edge_next = std::next(change.edge);
+
+  journal.out_edges.splice(journal.out_edges.end(), v_edges, change.v_edge);
+  journal.out_edges.splice(journal.out_edges.end(), u_edges, change.u_edge);
+  journal.edges.splice(journal.edges.end(), g.m_edges, change.edge);
+  journal.changes.push_back(change);
+}
+
+/**
+  @brief Undo \e change in \e g
+
+  @param[in]     change  Change
+  @param[in,out] g       Red-black graph
+  @param[in,out] journal Undo journal of \e g
+*/
+static void undo(const RBChange& change, RBGraph& g, RBJournal& journal) {
+  switch (change.kind) {
+    case RBChange::Kind::add_vertex:
+      remove_vertex(change.v, g);
+      break;
+
+    case RBChange::Kind::remove_vertex:
+      {
+        const auto v = change.v;
+
+        g.vertex_set().splice(change.vertex_next, journal.vertices,
+                              change.vertex);
+
+        vertex_map(g[v].type, g)[g[v].id] = v;
+
+        if (is_species(v, g))
+          num_species(g)++;
+        else
+          num_characters(g)++;
+
+        add_singleton_component(v, g);
+      }
+      break;
+
+    case RBChange::Kind::add_edge:
+      remove_edge(change.e, g);
+      break;
+
+    case RBChange::Kind::remove_edge:
+      {
+        const auto v = change.v, u = change.u;
+
+        g.m_edges.splice(change.edge_next, journal.edges, change.edge);
+        g.out_edge_list(v).splice(change.v_edge_next, journal.out_edges,
+                                  change.v_edge);
+        g.out_edge_list(u).splice(change.u_edge_next, journal.out_edges,
+                                  change.u_edge);
+
+        const auto color = change.edge->get_property().color;
+
+        if (color == Color::red) {
+          g[v].red_degree++;
+          g[u].red_degree++;
+        } else {
+          g[v].black_degree++;
+          g[u].black_degree++;
+        }
+
+        touch_sigma(v, u, color, true, g);
+
+        const auto& comps = g[boost::graph_bundle].components;
+
+        if (comps.valid && label(v, g) != label(u, g)) {
+          // the components of v and u are merged
+          touch_component(v, g);
+          touch_component(u, g);
+        }
+      }
+      break;
+
+    case RBChange::Kind::change_char_type:
+      change_char_type(change.v, g);
+      break;
+  }
+}
+
+size_t checkpoint(RBGraph& g) {
+  auto& journal = g[boost::graph_bundle].journal.journal;
+
+  if (!journal) journal.reset(new RBJournal);
+
+  journal->checkpoints.push_back(journal->changes.size());
+
+  return journal->checkpoints.size() - 1;
+}
+
+void rollback(const size_t checkpoint, RBGraph& g) {
+  auto* const journal = g[boost::graph_bundle].journal.journal.get();
+
+  if (journal == nullptr || checkpoint >= journal->checkpoints.size()) return;
+
+  // undo the changes without recording them
+  journal->replaying = true;
+
+  while (journal->changes.size() > journal->checkpoints[checkpoint]) {
+    undo(journal->changes.back(), g, *journal);
+    journal->changes.pop_back();
+  }
+
+  journal->checkpoints.resize(checkpoint);
+  journal->replaying = false;
+}
 
 //=============================================================================
 // Boost functions (overloading)
@@ -14,42 +778,45 @@ void remove_vertex(const RBVertex v, RBGraph& g) {
     num_characters(g)--;
 
   // delete v from the map
-  vertex_map(g).erase(g[v].name);
+  auto& v_map = vertex_map(g[v].type, g);
+  if (g[v].id < v_map.size() && v_map[g[v].id] == v) {
+    v_map[g[v].id] = RBGraph::null_vertex();
 
-  boost::remove_vertex(v, g);
-}
+    remove_singleton_component(v, g);
+  }
 
-void remove_vertex(const std::string& name, RBGraph& g) {
-  // find v in the map
-  const auto v = vertex_map(g).at(name);
+  auto* const journal = recording(g);
 
-  if (is_species(v, g))
-    num_species(g)--;
-  else
-    num_characters(g)--;
+  if (journal) {
+    // keep v, so that it can be put back in its position
+    detach_vertex(v, g, *journal);
 
-  // delete v from the map
-  vertex_map(g).erase(name);
+    return;
+  }
 
   boost::remove_vertex(v, g);
 }
 
-RBVertex add_vertex(const std::string& name, const Type type, RBGraph& g) {
-  try {
-    // if a vertex with the same name already exists
-    const auto u = vertex_map(g).at(name);
+void remove_vertex(const std::string& name, RBGraph& g) {
+  remove_vertex(get_vertex(name, g), g);
+}
+
+RBVertex add_vertex(const size_t id, const Type type, RBGraph& g) {
+  auto& v_map = vertex_map(type, g);
+
+  // if a vertex with the same ID already exists
+  if (id < v_map.size() && v_map[id] != RBGraph::null_vertex())
     // return its descriptor and do nothing
-    return u;
-  } catch (const std::out_of_range& e) {
-    // continue with the algorithm
-  }
+    return v_map[id];
 
   const auto v = boost::add_vertex(g);
 
   // insert v in the map
-  vertex_map(g)[name] = v;
+  if (id >= v_map.size()) v_map.resize(id + 1, RBGraph::null_vertex());
 
-  g[v].name = name;
+  v_map[id] = v;
+
+  g[v].id = id;
   g[v].type = type;
 
   if (is_species(v, g))
@@ -57,33 +824,139 @@ RBVertex add_vertex(const std::string& name, const Type type, RBGraph& g) {
   else
     num_characters(g)++;
 
+  add_singleton_component(v, g);
+
+  auto* const journal = recording(g);
+
+  if (journal) journal->changes.push_back({RBChange::Kind::add_vertex, v});
+
   return v;
 }
 
+RBVertex add_vertex(const std::string& name, const Type type, RBGraph& g) {
+  return add_vertex(intern_name(name, type), type, g);
+}
+
 std::pair<RBEdge, bool> add_edge(const RBVertex u, const RBVertex v,
                                  const Color color, RBGraph& g) {
+  const auto& comps = g[boost::graph_bundle].components;
+
+  if (comps.valid && label(u, g) != label(v, g)) {
+    // the components of u and v are merged
+    touch_component(u, g);
+    touch_component(v, g);
+  }
+
   RBEdge e;
   bool exists;
   std::tie(e, exists) = boost::add_edge(u, v, g);
   g[e].color = color;
 
+  if (color == Color::red) {
+    g[u].red_degree++;
+    g[v].red_degree++;
+  } else {
+    g[u].black_degree++;
+    g[v].black_degree++;
+  }
+
+  touch_sigma(u, v, color, true, g);
+
+  auto* const journal = recording(g);
+
+  if (journal) {
+    journal->changes.push_back({RBChange::Kind::add_edge, u});
+    journal->changes.back().e = e;
+  }
+
   return std::make_pair(e, exists);
 }
 
+void remove_edge(const RBEdge e, RBGraph& g) {
+  const auto u = source(e, g);
+  const auto v = target(e, g);
+
+  // the component of e may be split
+  touch_component(u, g);
+  touch_component(v, g);
+
+  if (is_red(e, g)) {
+    g[u].red_degree--;
+    g[v].red_degree--;
+  } else {
+    g[u].black_degree--;
+    g[v].black_degree--;
+  }
+
+  touch_sigma(u, v, g[e].color, false, g);
+
+  auto* const journal = recording(g);
+
+  if (journal) {
+    // keep e, so that it can be put back in its position
+    detach_edge(e, g, *journal);
+
+    return;
+  }
+
+  boost::remove_edge(e, g);
+}
+
+void clear_vertex(const RBVertex v, RBGraph& g) {
+  // remove the edges one at a time, so the components and the edge counters
+  // are updated by remove_edge
+  while (out_degree(v, g) > 0) {
+    remove_edge(*out_edges(v, g).first, g);
+  }
+}
+
 //=============================================================================
 // General functions
 
+RBVertex get_vertex(const std::string& name, const RBGraph& g) {
+  for (const auto type : {Type::species, Type::character}) {
+    // for each type, search the ID of name and then its vertex
+    size_t id = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(names_mutex);
+
+      const auto& table = name_table(type);
+      const auto it = table.ids.find(name);
+
+      if (it == table.ids.cend()) continue;
+
+      id = it->second;
+    }
+
+    const auto& v_map = vertex_map(type, g);
+
+    if (id < v_map.size() && v_map[id] != RBGraph::null_vertex())
+      return v_map[id];
+  }
+
+  throw std::out_of_range(name);
+}
+
 void build_vertex_map(RBGraph& g) {
-  vertex_map(g).clear();
+  vertex_map(Type::species, g).clear();
+  vertex_map(Type::character, g).clear();
 
   RBVertexIter v, v_end;
   std::tie(v, v_end) = vertices(g);
   for (; v != v_end; ++v) {
-    vertex_map(g)[g[*v].name] = *v;
+    auto& v_map = vertex_map(g[*v].type, g);
+
+    if (g[*v].id >= v_map.size())
+      v_map.resize(g[*v].id + 1, RBGraph::null_vertex());
+
+    v_map[g[*v].id] = *v;
   }
 }
 
 void copy_graph(const RBGraph& g, RBGraph& g_copy) {
+  stats::count(stats::Counter::copy_graph);
+
   RBVertexIMap index_map;
   RBVertexIAssocMap index_assocmap(index_map);
 
@@ -103,402 +976,738 @@ void copy_graph(const RBGraph& g, RBGraph& g_copy) {
 
   // rebuild g_copy's map
   build_vertex_map(g_copy);
+
+  // restore the edge counters
+  copy_degrees(g, g_copy);
+
+  // vertices keep their IDs, so the components and the red Σ-graphs of g
+  // are still valid
+  g_copy[boost::graph_bundle].components = g[boost::graph_bundle].components;
+  g_copy[boost::graph_bundle].sigma = g[boost::graph_bundle].sigma;
 }
 
 void copy_graph(const RBGraph& g, RBGraph& g_copy, RBVertexMap& v_map) {
+  stats::count(stats::Counter::copy_graph);
+
   RBVertexIMap index_map;
   RBVertexAssocMap v_assocmap(v_map);
   RBVertexIAssocMap index_assocmap(index_map);
 
-  // fill the vertex index map index_assocmap
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (size_t index = 0; u != u_end; ++u, ++index) {
-    boost::put(index_assocmap, *u, index);
+  // fill the vertex index map index_assocmap
+  RBVertexIter u, u_end;
+  std::tie(u, u_end) = vertices(g);
+  for (size_t index = 0; u != u_end; ++u, ++index) {
+    boost::put(index_assocmap, *u, index);
+  }
+
+  // copy g to g_copy, fill the vertex map v_assocmap (and v_map)
+  copy_graph(g, g_copy,
+             boost::vertex_index_map(index_assocmap).orig_to_copy(v_assocmap));
+
+  // update g_copy's number of species and characters
+  num_species(g_copy) = num_species(g);
+  num_characters(g_copy) = num_characters(g);
+
+  // rebuild g_copy's map
+  build_vertex_map(g_copy);
+
+  // restore the edge counters
+  copy_degrees(g, g_copy);
+
+  // vertices keep their IDs, so the components and the red Σ-graphs of g
+  // are still valid
+  g_copy[boost::graph_bundle].components = g[boost::graph_bundle].components;
+  g_copy[boost::graph_bundle].sigma = g[boost::graph_bundle].sigma;
+}
+
+/**
+  @brief Struct used to represent the name of a vertex while printing a
+         red-black graph
+*/
+struct RBPrintName {
+  size_t index{};             ///< Index of the name (see name_index)
+  const std::string* name{};  ///< Name
+};
+
+/**
+  @brief Struct used to represent an edge while printing a red-black graph
+*/
+struct RBPrintEdge {
+  size_t index{};             ///< Index of the name of the target
+  const std::string* name{};  ///< Name of the target
+  bool red{};                 ///< True if the edge is red
+};
+
+void print_adjacency(std::ostream& os, const RBGraph& g, const bool stream) {
+  // name of each species and character ID of g
+  std::vector<RBPrintName> s_names(vertex_map(Type::species, g).size());
+  std::vector<RBPrintName> c_names(vertex_map(Type::character, g).size());
+
+  // species and characters, in the order they're printed
+  std::vector<RBVertex> species, characters;
+  species.reserve(num_species(g));
+  characters.reserve(num_characters(g));
+
+  // the last vertex of g has no newline, wherever it's printed
+  RBVertex last = RBGraph::null_vertex();
+
+  {
+    // the names are taken once, so the name tables are locked once
+    std::lock_guard<std::mutex> lock(names_mutex);
+
+    RBVertexIter v, v_end;
+    std::tie(v, v_end) = vertices(g);
+    for (; v != v_end; ++v) {
+      const auto& table = name_table(g[*v].type);
+      auto& name = (is_species(*v, g) ? s_names : c_names)[g[*v].id];
+      name.index = table.indices[g[*v].id];
+      name.name = &table.names[g[*v].id];
+
+      (is_species(*v, g) ? species : characters).push_back(*v);
+      last = *v;
+    }
+  }
+
+  const auto get_print_name = [&](const RBVertex v) -> const RBPrintName& {
+    return (is_species(v, g) ? s_names : c_names)[g[v].id];
+  };
+
+  const auto compare_vertices = [&](const RBVertex a, const RBVertex b) {
+    return get_print_name(a).index < get_print_name(b).index;
+  };
+
+  // stable sorts keep the vertices and the edges with the same index in the
+  // order they're visited
+  std::stable_sort(species.begin(), species.end(), compare_vertices);
+  std::stable_sort(characters.begin(), characters.end(), compare_vertices);
+
+  std::string out;
+
+  if (!stream) {
+    // the whole dump is built in out, which is allocated once
+    size_t size = 0;
+
+    RBVertexIter v, v_end;
+    std::tie(v, v_end) = vertices(g);
+    for (; v != v_end; ++v) {
+      size += get_print_name(*v).name->size() + (*v == last ? 1 : 2);
+
+      RBOutEdgeIter e, e_end;
+      std::tie(e, e_end) = out_edges(*v, g);
+      for (; e != e_end; ++e) {
+        size += get_print_name(target(*e, g)).name->size() + 6;
+      }
+    }
+
+    out.reserve(size);
+  }
+
+  std::vector<RBPrintEdge> edges;
+
+  const auto print_vertex = [&](const RBVertex v) {
+    edges.clear();
+
+    RBOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(v, g);
+    for (; e != e_end; ++e) {
+      const auto& name = get_print_name(target(*e, g));
+
+      edges.push_back({name.index, name.name, is_red(*e, g)});
+    }
+
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const RBPrintEdge& a, const RBPrintEdge& b) {
+                       return a.index < b.index;
+                     });
+
+    if (stream) out.clear();
+
+    out += *get_print_name(v).name;
+    out += ':';
+
+    for (const auto& edge : edges) {
+      out += (edge.red ? " -r- " : " --- ");
+      out += *edge.name;
+      out += ';';
+    }
+
+    if (v != last) out += '\n';
+
+    // streaming enabled
+    if (stream) os.write(out.data(), out.size());
+  };
+
+  for (const auto v : species) print_vertex(v);
+  for (const auto v : characters) print_vertex(v);
+
+  if (!stream) os.write(out.data(), out.size());
+}
+
+std::ostream& operator<<(std::ostream& os, const RBGraph& g) {
+  print_adjacency(os, g);
+
+  return os;
+}
+
+// File I/O
+
+/**
+  @brief Struct used to access the contents of an input file in memory
+
+  Regular files are mapped read-only, other files (e.g. pipes) are read into
+  \e buffer.
+*/
+struct RBInputFile {
+  const char* data{};          ///< Contents of the file
+  size_t size{};               ///< Size of the file
+  void* mapping{};             ///< Mapped region, if the file is mapped
+  std::vector<char> buffer{};  ///< Contents of the file, if it isn't mapped
+
+  /**
+    @brief Map or read \e filename
+
+    Throws std::runtime_error if \e filename can't be opened.
+
+    @param[in] filename Filename
+  */
+  explicit RBInputFile(const std::string& filename) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+      // input file doesn't exist
+      throw std::runtime_error(
+          "Failed to read graph from file: no such file or directory");
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (mapping != MAP_FAILED) {
+        madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+        data = static_cast<const char*>(mapping);
+        size = st.st_size;
+      } else {
+        mapping = nullptr;
+      }
+    }
+
+    if (!mapping) {
+      // the file can't be mapped, read it (errors are read as end of file)
+      char chunk[1 << 16];
+      ssize_t n;
+
+      while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + n);
+      }
+
+      data = buffer.data();
+      size = buffer.size();
+    }
+
+    close(fd);
+  }
+
+  ~RBInputFile() {
+    if (mapping) munmap(mapping, size);
   }
 
-  // copy g to g_copy, fill the vertex map v_assocmap (and v_map)
-  copy_graph(g, g_copy,
-             boost::vertex_index_map(index_assocmap).orig_to_copy(v_assocmap));
+  RBInputFile(const RBInputFile&) = delete;
+  RBInputFile& operator=(const RBInputFile&) = delete;
+};
 
-  // update g_copy's number of species and characters
-  num_species(g_copy) = num_species(g);
-  num_characters(g_copy) = num_characters(g);
+/**
+  @brief Check if \e c is a whitespace, as skipped by operator>>
 
-  // rebuild g_copy's map
-  build_vertex_map(g_copy);
+  @param[in] c Char
+
+  @return True if \e c is a whitespace
+*/
+static inline bool is_blank(const char c) {
+  return (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+          c == '\f');
 }
 
-std::ostream& operator<<(std::ostream& os, const RBGraph& g) {
-  std::list<std::string> lines;
-  std::list<std::string> species;
-  std::list<std::string> characters;
+/**
+  @brief Insert \e num_s species and \e num_c characters in \e g, named after
+         their index in the matrix
+
+  @param[in]  num_s      Number of species
+  @param[in]  num_c      Number of characters
+  @param[out] species    Species vertices
+  @param[out] characters Character vertices
+  @param[out] g          Red-black graph
+*/
+static void add_matrix_vertices(const size_t num_s, const size_t num_c,
+                                std::vector<RBVertex>& species,
+                                std::vector<RBVertex>& characters,
+                                RBGraph& g) {
+  species.resize(num_s);
+  characters.resize(num_c);
+
+  for (size_t j = 0; j < species.size(); ++j) {
+    const auto v_name = "s" + std::to_string(j);
+
+    species[j] = add_vertex(v_name, Type::species, g);
+  }
 
-  RBVertexIter v, v_end;
-  std::tie(v, v_end) = vertices(g);
-  for (size_t i = 0; v != v_end; ++v, ++i) {
-    std::list<std::string> edges;
+  for (size_t j = 0; j < characters.size(); ++j) {
+    const auto v_name = "c" + std::to_string(j);
 
-    RBOutEdgeIter e, e_end;
-    std::tie(e, e_end) = out_edges(*v, g);
-    for (size_t j = 0; e != e_end; ++e, ++j) {
-      std::string edge;
-      edge += " -";
-      edge += (is_red(*e, g) ? "r" : "-");
-      edge += "- ";
-      edge += g[target(*e, g)].name;
-      edge += ";";
+    characters[j] = add_vertex(v_name, Type::character, g);
+  }
+}
 
-      edges.push_back(edge);
-    }
+/**
+  @brief Read the text matrix in the \e size bytes at \e data into \e g
 
-    auto compare_edges = [](const std::string& a, const std::string& b) {
-      size_t a_index, b_index;
-      std::stringstream ss;
+  @param[in]  data Contents of the input file
+  @param[in]  size Size of the input file
+  @param[out] g    Red-black graph
+*/
+static void read_text_graph(const char* data, const size_t size,
+                            RBGraph& g) {
+  const char* p = data;
+  const char* const end = data + size;
 
-      ss.str(a.substr(6, a.size() - 7));
-      ss >> a_index;
+  if (p == end) {
+    // input file parsing error
+    throw std::runtime_error("Failed to read graph from file: empty file");
+  }
 
-      ss.clear();
+  // first line: number of species, number of characters and active
+  // characters
+  const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  if (!eol) eol = end;
 
-      ss.str(b.substr(6, b.size() - 7));
-      ss >> b_index;
+  size_t num_s = 0, num_c = 0;
+  size_t cont = 0;
+  std::vector<size_t> a_chars;
 
-      return a_index < b_index;
-    };
+  while (true) {
+    while (p != eol && is_blank(*p)) ++p;
 
-    edges.sort(compare_edges);
+    if (p == eol || *p < '0' || *p > '9') break;
 
-    std::string edges_str;
-    for (const auto& edge : edges) {
-      edges_str.append(edge);
+    size_t read = 0;
+    for (; p != eol && *p >= '0' && *p <= '9'; ++p) {
+      read = read * 10 + (*p - '0');
     }
 
-    auto line(g[*v].name + ":" + edges_str);
-
-    if (std::next(v) != v_end) line += "\n";
+    if (cont == 0) {
+      num_s = read;
+      cont++;
+    } else if (cont == 1) {
+      num_c = read;
+      cont++;
+    } else {
+      if (read >= num_c)
+        throw std::runtime_error(
+            "Failed to read graph from file: Inexistent character");
+      a_chars.push_back(read);
+    }
 
-    if (is_species(*v, g))
-      species.push_back(line);
-    else
-      characters.push_back(line);
+    // a number followed by something else ends the line, as for operator>>
+    if (p != eol && !is_blank(*p)) break;
   }
 
-  auto compare_lines = [](const std::string& a, const std::string& b) {
-    size_t a_index, b_index;
-    std::stringstream ss;
+  if (num_s == 0 || num_c == 0) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: badly formatted line 0");
+  }
 
-    ss.str(a.substr(1, a.find(":")));
-    ss >> a_index;
+  std::vector<RBVertex> species, characters;
+  add_matrix_vertices(num_s, num_c, species, characters, g);
+
+  // read binary matrix, the species and character of the current value are
+  // kept instead of its index
+  const auto num_values = num_s * num_c;
+  size_t index = 0, s_index = 0, c_index = 0;
+
+  for (p = eol; p < end; ++p) {
+    switch (*p) {
+      case '1':
+        if (index >= num_values) {
+          // input file parsing error
+          throw std::runtime_error(
+              "Failed to read graph from file: oversized matrix");
+        }
 
-    ss.clear();
+        // add edge between species[s_index] and characters[c_index]
+        add_edge(species[s_index], characters[c_index], g);
 
-    ss.str(b.substr(1, b.find(":")));
-    ss >> b_index;
+        // fall through
+      case '0':
+        index++;
 
-    return a_index < b_index;
-  };
+        if (++c_index == num_c) {
+          c_index = 0;
+          s_index++;
+        }
+        break;
 
-  species.sort(compare_lines);
-  characters.sort(compare_lines);
+      case ' ':
+      case '\n':
+      case '\t':
+      case '\r':
+      case '\v':
+      case '\f':
+        break;
 
-  lines.splice(lines.end(), species);
-  lines.splice(lines.end(), characters);
+      default:
+        // input file parsing error
+        throw std::runtime_error(
+            "Failed to read graph from file: unexpected value in matrix");
+    }
+  }
 
-  std::string lines_str;
-  for (const auto& line : lines) {
-    lines_str += line;
+  if (index != num_values) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: undersized matrix");
   }
 
-  os << lines_str;
+  for (const auto& elem : a_chars) {
+    change_char_type(characters[elem], g);
+  }
+}
 
-  return os;
+/**
+  @brief Magic bytes at the start of a binary matrix file
+*/
+static const char binary_magic[4] = {'P', 'P', 'P', 'B'};
+
+/**
+  @brief Version of the binary matrix format written by write_graph
+*/
+static constexpr uint32_t binary_version = 1;
+
+/**
+  @brief Size of the fixed part of the header of a binary matrix file: magic,
+         version, number of species, characters and active characters, and
+         checksum
+*/
+static constexpr size_t binary_header_size = 40;
+
+/**
+  @brief Append \e value to \e out in \e size little-endian bytes
+
+  @param[in]     value Value
+  @param[in]     size  Number of bytes
+  @param[in,out] out   Output buffer
+*/
+static void put_le(const uint64_t value, const size_t size, std::string& out) {
+  for (size_t i = 0; i < size; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
 }
 
-// File I/O
+/**
+  @brief Return the value stored in the \e size little-endian bytes at \e p
 
-void read_graph(const std::string& filename, RBGraph& g) {
-  std::vector<RBVertex> species, characters;
-  bool first_line = true;
-  std::string line;
-  std::ifstream file(filename);
-  std::vector<std::string> a_chars;
+  @param[in] p    Bytes
+  @param[in] size Number of bytes
 
-  if (!file) {
-    // input file doesn't exist
-    throw std::runtime_error(
-        "Failed to read graph from file: no such file or directory");
+  @return Value
+*/
+static uint64_t get_le(const unsigned char* p, const size_t size) {
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < size; ++i) {
+    value |= uint64_t(p[i]) << (8 * i);
   }
 
-  size_t index = 0;
-  while (std::getline(file, line)) {
-    // for each line in file
-    std::istringstream iss(line);
+  return value;
+}
 
-    if (first_line) {
-      size_t cont = 0;
-      size_t read;
-      size_t num_s, num_c;
+/**
+  @brief Update the FNV-1a hash \e hash with \e size bytes at \e p
 
-      while(iss >> read) {
-        if(cont == 0){
-          num_s = read;
-          cont++;
-        }
-        else if(cont == 1) {
-          num_c = read;
-          cont++;
-        }
-        else {
-          if(read >= num_c)
-            throw std::runtime_error("Failed to read graph from file: Inexistent character");
-          std::string s = "c" + std::to_string(read);
-          a_chars.push_back(s);
-        }
-      }
+  @param[in] p    Bytes
+  @param[in] size Number of bytes
+  @param[in] hash Hash of the previous bytes
 
-      species.resize(num_s);
-      characters.resize(num_c);
+  @return Updated hash
+*/
+static uint64_t fnv1a(const unsigned char* p, const size_t size,
+                      uint64_t hash = 0xcbf29ce484222325) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ p[i]) * 0x100000001b3;
+  }
 
-      if (species.size() == 0 || characters.size() == 0) {
-        // input file parsing error
-        throw std::runtime_error(
-            "Failed to read graph from file: badly formatted line 0");
-      }
+  return hash;
+}
 
-      // insert species in the graph
-      for (size_t j = 0; j < species.size(); ++j) {
-        const auto v_name = "s" + std::to_string(j);
+/**
+  @brief Read the binary matrix in the \e size bytes at \e data into \e g
 
-        species[j] = add_vertex(v_name, Type::species, g);
-      }
+  @param[in]  data Contents of the input file
+  @param[in]  size Size of the input file
+  @param[out] g    Red-black graph
+*/
+static void read_binary_graph(const char* data, const size_t size,
+                              RBGraph& g) {
+  const auto* const p = reinterpret_cast<const unsigned char*>(data);
 
-      // insert characters in the graph
-      for (size_t j = 0; j < characters.size(); ++j) {
-        const auto v_name = "c" + std::to_string(j);
+  if (size < binary_header_size) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: badly formatted header");
+  }
 
-        characters[j] = add_vertex(v_name, Type::character, g);
-      }
+  if (get_le(p + 4, 4) != binary_version) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: unsupported binary format version");
+  }
 
-      first_line = false;
-    } 
-    else {
-      char value;
-
-      // read binary matrix
-      while (iss >> value) {
-        switch (value) {
-          case '1':
-            // add edge between species[s_index] and characters[c_index]
-            {
-              const auto s_index = index / characters.size(),
-                         c_index = index % characters.size();
-
-              if (s_index >= species.size() || c_index >= characters.size()) {
-                // input file parsing error
-                throw std::runtime_error(
-                    "Failed to read graph from file: oversized matrix");
-              }
-
-              RBEdge edge;
-              std::tie(edge, std::ignore) =
-                  add_edge(species[s_index], characters[c_index], g);
-
-              //if (red_edge) g[edge].color = Color::red;
-            }
-            break;
-
-          case '0':
-            // ignore
-            break;
-
-          default:
-            // input file parsing error
-            throw std::runtime_error(
-                "Failed to read graph from file: unexpected value in matrix");
-        }
+  const auto num_s = get_le(p + 8, 8);
+  const auto num_c = get_le(p + 16, 8);
+  const auto num_a = get_le(p + 24, 8);
+  const auto checksum = get_le(p + 32, 8);
 
-        index++;
-      }
-    }
+  if (num_s == 0 || num_c == 0) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: badly formatted header");
   }
 
-  
+  // sizes are checked against the size of the file before being multiplied
+  auto remaining = size - binary_header_size;
+  const auto row_size = num_c / 8 + (num_c % 8 != 0);
 
-  if (index != species.size() * characters.size()) {
+  if (num_a > remaining / 8 || num_s > (remaining - num_a * 8) / row_size) {
     // input file parsing error
     throw std::runtime_error(
         "Failed to read graph from file: undersized matrix");
   }
 
-  if (species.size() == 0 || characters.size() == 0) {
+  remaining -= num_a * 8;
+
+  if (remaining > num_s * row_size) {
     // input file parsing error
-    throw std::runtime_error("Failed to read graph from file: empty file");
+    throw std::runtime_error(
+        "Failed to read graph from file: oversized matrix");
   }
 
-  for(const auto& elem : a_chars)
-    change_char_type(vertex_map(g).at(elem), g);
-
-  
-}
-//=============================================================================
-// Algorithm functions
-
-bool is_active(const RBVertex v, const RBGraph& g) {
-  if (!is_character(v, g)) return false;
+  const auto* const a_bytes = p + binary_header_size;
+  const auto* const body = a_bytes + num_a * 8;
 
-  RBOutEdgeIter e, e_end;
-  std::tie(e, e_end) = out_edges(v, g);
-  for (; e != e_end; ++e) {
-    if (!is_red(*e, g) || !is_species(target(*e, g), g)) return false;
+  if (fnv1a(body, remaining, fnv1a(a_bytes, num_a * 8)) != checksum) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read graph from file: checksum mismatch");
   }
 
-  return true;
-}
+  std::vector<size_t> a_chars(num_a);
 
-bool is_inactive(const RBVertex v, const RBGraph& g) {
-  if (!is_character(v, g)) return false;
+  for (size_t i = 0; i < num_a; ++i) {
+    a_chars[i] = get_le(a_bytes + i * 8, 8);
 
-  RBOutEdgeIter e, e_end;
-  std::tie(e, e_end) = out_edges(v, g);
-  for (; e != e_end; ++e) {
-    if (!is_black(*e, g) || !is_species(target(*e, g), g)) return false;
+    if (a_chars[i] >= num_c)
+      throw std::runtime_error(
+          "Failed to read graph from file: Inexistent character");
   }
 
-  return true;
-}
+  // the padding bits at the end of each row must be zero
+  const unsigned char padding = (0xff << (num_c % 8)) & 0xff;
 
-void remove_singletons(RBGraph& g) {
-  RBVertexIter v, v_end, next;
-  std::tie(v, v_end) = vertices(g);
-  for (next = v; v != v_end; v = next) {
-    next++;
-    remove_vertex_if(*v, if_singleton(), g);
+  for (size_t s = 0; num_c % 8 != 0 && s < num_s; ++s) {
+    if (body[s * row_size + row_size - 1] & padding) {
+      // input file parsing error
+      throw std::runtime_error(
+          "Failed to read graph from file: unexpected value in matrix");
+    }
   }
-}
 
-bool is_free(const RBVertex v, const RBGraph& g) {
-  if (!is_character(v, g)) return false;
+  std::vector<RBVertex> species, characters;
+  add_matrix_vertices(num_s, num_c, species, characters, g);
 
-  RBVertexIMap index_map, comp_map;
-  RBVertexIAssocMap index_assocmap(index_map), comp_assocmap(comp_map);
+  for (size_t s = 0; s < num_s; ++s) {
+    const auto* const row = body + s * row_size;
 
-  // fill vertex index map
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (size_t index = 0; u != u_end; ++u, ++index) {
-    boost::put(index_assocmap, *u, index);
+    for (size_t i = 0; i < row_size; ++i) {
+      // for each set bit of the row, add edge between species[s] and the
+      // character of the bit
+      for (unsigned bits = row[i]; bits != 0; bits &= bits - 1) {
+        add_edge(species[s], characters[i * 8 + __builtin_ctz(bits)], g);
+      }
+    }
   }
 
-  // build the components map
-  boost::connected_components(g, comp_assocmap,
-                              boost::vertex_index_map(index_assocmap));
+  for (const auto& elem : a_chars) {
+    change_char_type(characters[elem], g);
+  }
+}
+
+void read_graph(const std::string& filename, RBGraph& g) {
+  const RBInputFile file(filename);
 
-  return is_free(v, g, comp_map);
+  read_graph(file.data, file.size, g);
 }
 
-bool is_free(const RBVertex v, const RBGraph& g, const RBVertexIMap& c_map) {
-  if (!is_character(v, g)) return false;
+void read_graph(const char* data, const size_t size, RBGraph& g) {
+  if (size >= sizeof(binary_magic) &&
+      std::memcmp(data, binary_magic, sizeof(binary_magic)) == 0)
+    read_binary_graph(data, size, g);
+  else
+    read_text_graph(data, size, g);
+}
 
-  size_t tot_species = 0;
+void write_graph(const std::string& filename, const RBGraph& g,
+                 const bool binary) {
+  const auto& s_map = vertex_map(Type::species, g);
+  const auto& c_map = vertex_map(Type::character, g);
+  const auto num_s = s_map.size(), num_c = c_map.size();
 
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (; u != u_end; ++u) {
-    if (!is_species(*u, g) || c_map.at(v) != c_map.at(*u)) continue;
+  // active characters are the ones with red edges
+  std::vector<size_t> a_chars;
 
-    tot_species++;
+  for (size_t c = 0; c < num_c; ++c) {
+    if (c_map[c] != RBGraph::null_vertex() && red_degree(c_map[c], g) > 0)
+      a_chars.push_back(c);
   }
 
-  size_t count_species = 0;
+  // bit-packed rows of the matrix
+  const auto row_size = num_c / 8 + (num_c % 8 != 0);
+  std::string body(num_s * row_size, '\0');
 
-  RBOutEdgeIter e, e_end;
-  std::tie(e, e_end) = out_edges(v, g);
-  for (; e != e_end; ++e) {
-    if (!is_red(*e, g) || !is_species(target(*e, g), g)) return false;
+  for (size_t s = 0; s < num_s; ++s) {
+    if (s_map[s] == RBGraph::null_vertex()) continue;
+
+    RBOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(s_map[s], g);
+    for (; e != e_end; ++e) {
+      const auto c = g[target(*e, g)].id;
+
+      body[s * row_size + c / 8] |= static_cast<char>(1 << (c % 8));
+    }
+  }
+
+  std::string out;
+
+  if (binary) {
+    std::string a_bytes;
+    for (const auto c : a_chars) {
+      put_le(c, 8, a_bytes);
+    }
 
-    count_species++;
+    const auto checksum = fnv1a(
+        reinterpret_cast<const unsigned char*>(body.data()), body.size(),
+        fnv1a(reinterpret_cast<const unsigned char*>(a_bytes.data()),
+              a_bytes.size()));
+
+    out.append(binary_magic, sizeof(binary_magic));
+    put_le(binary_version, 4, out);
+    put_le(num_s, 8, out);
+    put_le(num_c, 8, out);
+    put_le(a_chars.size(), 8, out);
+    put_le(checksum, 8, out);
+    out += a_bytes;
+    out += body;
+  } else {
+    out += std::to_string(num_s) + " " + std::to_string(num_c);
+    for (const auto c : a_chars) {
+      out += " " + std::to_string(c);
+    }
+    out += "\n\n";
+
+    for (size_t s = 0; s < num_s; ++s) {
+      for (size_t c = 0; c < num_c; ++c) {
+        out += ((body[s * row_size + c / 8] >> (c % 8)) & 1) ? '1' : '0';
+        out += (c + 1 < num_c ? ' ' : '\n');
+      }
+    }
   }
 
-  if (count_species != tot_species) return false;
+  std::ofstream file(filename, std::ios::binary);
+  file.write(out.data(), out.size());
 
-  return true;
+  if (!file) {
+    // output file error
+    throw std::runtime_error("Failed to write graph to file: " + filename);
+  }
 }
 
-bool is_universal(const RBVertex v, const RBGraph& g) {
-  if (!is_character(v, g)) return false;
+//=============================================================================
+// Algorithm functions
 
-  RBVertexIMap index_map, comp_map;
-  RBVertexIAssocMap index_assocmap(index_map), comp_assocmap(comp_map);
+bool is_active(const RBVertex v, const RBGraph& g) {
+  // characters are only incident on species, so only the colors are checked
+  return (is_character(v, g) && black_degree(v, g) == 0);
+}
 
-  // fill vertex index map
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (size_t index = 0; u != u_end; ++u, ++index) {
-    boost::put(index_assocmap, *u, index);
+bool is_inactive(const RBVertex v, const RBGraph& g) {
+  // characters are only incident on species, so only the colors are checked
+  return (is_character(v, g) && red_degree(v, g) == 0);
+}
+
+void remove_singletons(RBGraph& g) {
+  RBVertexIter v, v_end, next;
+  std::tie(v, v_end) = vertices(g);
+  for (next = v; v != v_end; v = next) {
+    next++;
+    remove_vertex_if(*v, if_singleton(), g);
   }
+}
 
-  // build the components map
-  boost::connected_components(g, comp_assocmap,
-                              boost::vertex_index_map(index_assocmap));
+size_t num_components(const RBGraph& g) {
+  update_components(g);
 
-  return is_universal(v, g, comp_map);
+  return g[boost::graph_bundle].components.count;
 }
 
-bool is_universal(const RBVertex v, const RBGraph& g,
-                  const RBVertexIMap& c_map) {
-  if (!is_character(v, g)) return false;
+size_t component(const RBVertex v, const RBGraph& g) {
+  update_components(g);
 
-  size_t tot_species = 0;
+  return label(v, g);
+}
 
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (; u != u_end; ++u) {
-    if (!is_species(*u, g) || c_map.at(v) != c_map.at(*u)) continue;
+size_t num_component_species(const size_t c, const RBGraph& g) {
+  update_components(g);
 
-    tot_species++;
-  }
+  return g[boost::graph_bundle].components.num_species[c];
+}
 
-  size_t count_species = 0;
+std::vector<size_t> components(const RBGraph& g) {
+  update_components(g);
 
-  RBOutEdgeIter e, e_end;
-  std::tie(e, e_end) = out_edges(v, g);
-  for (; e != e_end; ++e) {
-    if (!is_black(*e, g) || !is_species(target(*e, g), g)) return false;
+  const auto& comps = g[boost::graph_bundle].components;
+  std::vector<size_t> output;
 
-    count_species++;
+  for (size_t c = 0; c < comps.alive.size(); ++c) {
+    if (comps.alive[c]) output.push_back(c);
   }
 
-  if (count_species != tot_species) return false;
+  std::sort(output.begin(), output.end(), [&](const size_t a, const size_t b) {
+    return comps.first[a] < comps.first[b];
+  });
 
-  return true;
+  return output;
 }
 
-RBGraphVector connected_components(const RBGraph& g) {
-  RBVertexIMap index_map, comp_map;
-  RBVertexIAssocMap index_assocmap(index_map), comp_assocmap(comp_map);
+bool is_free(const RBVertex v, const RBGraph& g) {
+  if (!is_active(v, g)) return false;
 
-  // fill the vertex index map index_assocmap
-  RBVertexIter v, v_end;
-  std::tie(v, v_end) = vertices(g);
-  for (size_t index = 0; v != v_end; ++v, ++index) {
-    boost::put(index_assocmap, *v, index);
-  }
+  return (red_degree(v, g) == num_component_species(component(v, g), g));
+}
 
-  // get number of components and the components map
-  size_t comp_count = boost::connected_components(
-      g, comp_assocmap, boost::vertex_index_map(index_assocmap));
+bool is_universal(const RBVertex v, const RBGraph& g) {
+  if (!is_inactive(v, g)) return false;
 
-  // how comp_map is structured (after running boost::connected_components):
-  // comp_map[i] => < vertex_in_g, component_index >
-  return connected_components(g, comp_map, comp_count);
+  return (black_degree(v, g) == num_component_species(component(v, g), g));
 }
 
-RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
-                                   const size_t c_count) {
+RBGraphVector connected_components(const RBGraph& g) {
+  const auto labels = components(g);
+  const auto c_count = labels.size();
+
   RBGraphVector components;
   RBVertexMap vertices;
-  
+
   // how vertices is going to be structured:
   // vertices[vertex_in_g] => vertex_in_component
 
@@ -509,38 +1718,46 @@ RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
   for (size_t i = 0; i < c_count; ++i) {
     components[i] = std::make_unique<RBGraph>();
   }
-  
+
   if (c_count <= 1) {
     // graph is connected
     return components;
   }
   // graph is disconnected
 
+  // how index is going to be structured:
+  // index[component_label] => index of the subgraph in components
+  std::map<size_t, size_t> index;
+  for (size_t i = 0; i < c_count; ++i) {
+    index[labels[i]] = i;
+  }
+
   // add vertices to their respective subgraph
-  for (const auto& vcomp : c_map) {
+  RBVertexIter v, v_end;
+  std::tie(v, v_end) = boost::vertices(g);
+  for (; v != v_end; ++v) {
     // for each vertex
-    const auto v = vcomp.first;
-    const auto comp = vcomp.second;
+    const auto comp = index.at(component(*v, g));
     auto* const component = components[comp].get();
 
-    // add the vertex to *component and copy its descriptor in vertices[v]
-    vertices[v] = add_vertex(g[v].name, g[v].type, *component);
+    // add the vertex to *component and copy its descriptor in vertices[*v]
+    vertices[*v] = add_vertex(g[*v].id, g[*v].type, *component);
   }
 
   // add edges to their respective vertices and subgraph
-  for (const auto& vcomp : c_map) {
+  std::tie(v, v_end) = boost::vertices(g);
+  for (; v != v_end; ++v) {
     // for each vertex
-    const auto v = vcomp.first;
 
     // prevent duplicate edges from characters to species
-    if (!is_species(v, g)) continue;
+    if (!is_species(*v, g)) continue;
 
-    const auto new_v = vertices[v];
-    const auto comp = vcomp.second;
+    const auto new_v = vertices[*v];
+    const auto comp = index.at(component(*v, g));
     auto* const component = components[comp].get();
 
     RBOutEdgeIter e, e_end;
-    std::tie(e, e_end) = out_edges(v, g);
+    std::tie(e, e_end) = out_edges(*v, g);
     for (; e != e_end; ++e) {
       // for each out edge
       const auto new_vt = vertices[target(*e, g)];
@@ -555,15 +1772,15 @@ RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
     }
   }
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     
     if (c_count == 1) {
-      std::cout << "G connected" << std::endl;
+      *logging::stream << "G connected" << std::endl;
     } else {
-      std::cout << "Connected components: " << c_count << std::endl;
+      *logging::stream << "Connected components: " << c_count << std::endl;
 
       for (const auto& component : components) {
-        std::cout << *component.get() << std::endl << std::endl;
+        *logging::stream << *component.get() << std::endl << std::endl;
       }
     }
   }
@@ -572,11 +1789,13 @@ RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
 }
 
 const std::list<RBVertex> maximal_characters(const RBGraph& g) {
-  std::list<RBVertex> cm;
-  std::map<RBVertex, std::list<RBVertex>> adj_spec;
+  std::vector<RBVertex> characters;
+  std::vector<Bitset> adj_spec;
 
   // how adj_spec is going to be structured:
-  // adj_spec[C] => < List of adjacent species to C >
+  // adj_spec[i] => < Set of species (IDs) adjacent to characters[i] >
+
+  const auto n_species = vertex_map(Type::species, g).size();
 
   RBVertexIter v, v_end;
   std::tie(v, v_end) = vertices(g);
@@ -585,6 +1804,8 @@ const std::list<RBVertex> maximal_characters(const RBGraph& g) {
     // for each character vertex
 
     // build v's set of adjacent species
+    Bitset species(n_species);
+
     RBOutEdgeIter e, e_end;
     std::tie(e, e_end) = out_edges(*v, g);
     for (; e != e_end; ++e) {
@@ -593,99 +1814,64 @@ const std::list<RBVertex> maximal_characters(const RBGraph& g) {
       // if v is active or connected to random nodes ignore it
       if ((!active::enabled && is_red(*e, g)) || !is_species(vt, g)) break;
 
-      adj_spec[*v].push_back(vt);
+      species.set(g[vt].id);
     }
 
-    if (cm.empty()) {
-      // cm being empty means v can be added without further checks
-      cm.push_back(*v);
+    characters.push_back(*v);
+    adj_spec.push_back(std::move(species));
+  }
+
+  // visit the characters by number of species in descending order, so that a
+  // character can only be included in the ones visited before it; characters
+  // with the same number of species keep their order
+  std::vector<size_t> order(characters.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return adj_spec[a].count() > adj_spec[b].count();
+  });
+
+  // set of species of each character in cm, only the first character with a
+  // given set of species is kept
+  std::unordered_set<Bitset> cm_spec;
+  std::vector<size_t> cm_index;
+
+  for (const auto i : order) {
+    if (cm_spec.count(adj_spec[i]) > 0)
+      // a previous character has the same species
       continue;
-    }
 
-    // adj_spec[*v] now contains the list of species adjacent to v
+    bool included = false;
 
-    bool skip_cycle = false;
-    bool subst = false;
+    for (const auto j : cm_index) {
+      if (adj_spec[i].is_subset_of(adj_spec[j])) {
+        // characters[i] is included in characters[j]
+        included = true;
 
-    // check if adj_spec[*v] is subset of the species adjacent to cmv
-    RBVertexIter cmv = cm.begin(), cmv_end = cm.end();
-    for (; cmv != cmv_end; ++cmv) {
-      // for each species in cm
-      if (skip_cycle) break;
+        break;
+      }
+    }
 
-      size_t count_incl = 0;
-      size_t count_excl = 0;
-      bool keep_char = false;
+    if (included) continue;
 
-      RBVertexIter sv = adj_spec[*v].begin(), sv_end = adj_spec[*v].end();
-      for (; sv != sv_end; ++sv) {
-        // for each species adjacent to v, S(C#)
+    cm_spec.insert(adj_spec[i]);
+    cm_index.push_back(i);
+  }
 
-        // find sv in the list of cmv's adjacent species
-        std::list<RBVertex>::const_iterator in =
-            std::find(adj_spec[*cmv].cbegin(), adj_spec[*cmv].cend(), *sv);
+  // maximal characters are returned in the same order as in g
+  std::sort(cm_index.begin(), cm_index.end());
 
-        // keep count of how many species are included (or not found) in
-        // the list of cmv's adjacent species
-        if (in != adj_spec[*cmv].end())
-          count_incl++;
-        else
-          count_excl++;
-
-        if (std::next(sv) == sv_end) {
-          // last iteration on the species in the list has been performed
-          if (count_incl == adj_spec[*cmv].size() && count_excl > 0) {
-            // the list of adjacent species to v is a superset of the list of
-            // adjacent species to cmv, which means cmv can be replaced
-            // by v in the list of maximal characters Cm
-            if (subst) {
-              cm.remove(*(cmv++));
-            } else {
-              cm.push_front(*v);
-              cm.remove(*(cmv++));
-
-              subst = true;
-            }
-
-            cmv--;
-          } else if (count_incl < adj_spec[*cmv].size() && count_excl > 0) {
-            // the list of adjacent species to v is neither a superset nor a
-            // subset of the list of adjacent species to cmv, which means
-            // v may be a new maximal character
-            if (!subst) keep_char = true;
-          } else if (count_incl == adj_spec[*cmv].size()) {
-            // the list of adjacent species to v is the same as the list of
-            // adjacent species to cmv, so v can be ignored in the next
-            // iterations on the characters in Cm
-            skip_cycle = true;
-          } else if (count_excl == 0) {
-            // the list of adjacent species to v is a subset of the list of
-            // adjacent species to cmv, meaning v can be ignored in the
-            // next iterations on the characters in Cm
-            skip_cycle = true;
-          }
-        }
-      }
+  std::list<RBVertex> cm;
 
-      if (std::next(cmv) == cmv_end) {
-        // last iteration on the characters in the list has been performed
-        if (keep_char) {
-          // after all the iterations keep_char is true if the list of adjacent
-          // species to v is neither a superset nor a subset of the lists of
-          // adjacent species to the characters in Cm, so v is a maximal
-          // characters and can be added to the list of maximal characters Cm
-          cm.push_front(*v);
-        }
-      }
-    }
+  for (const auto i : cm_index) {
+    cm.push_back(characters[i]);
   }
 
-  cm.reverse();
-
   return cm;
 }
 
 RBGraph maximal_reducible_graph(const RBGraph& g, const bool active) {
+  const stats::Timer timer(stats::Stage::maximal_reducible_graph);
+
   // copy g to gm
   RBGraph gm;
   copy_graph(g, gm);
@@ -693,15 +1879,15 @@ RBGraph maximal_reducible_graph(const RBGraph& g, const bool active) {
   // compute the maximal characters of gm
   const auto cm = maximal_characters(gm);
 
-  if (logging::enabled) {
+  if (LOGGING(verbose)) {
     // verbosity enabled
-    std::cout << "Maximal characters Cm = { ";
+    *logging::stream << "Maximal characters Cm = { ";
 
     for (const auto& kk : cm) {
-      std::cout << gm[kk].name << " ";
+      *logging::stream << get_name(kk, gm) << " ";
     }
 
-    std::cout << "} - Count: " << cm.size() << std::endl;
+    *logging::stream << "} - Count: " << cm.size() << std::endl;
   }
 
   // remove non-maximal characters of gm
@@ -727,34 +1913,28 @@ RBGraph maximal_reducible_graph(const RBGraph& g, const bool active) {
 }
 
 bool has_red_sigmagraph(const RBGraph& g) {
-  size_t count_actives = 0;
+  stats::count(stats::Counter::sigma_checks);
 
-  RBVertexIter v, v_end;
-  std::tie(v, v_end) = vertices(g);
-  for (; v != v_end; ++v) {
-    if (is_active(*v, g)) count_actives++;
+  update_sigma(g);
 
-    if (count_actives == 2) break;
-  }
+  return (g[boost::graph_bundle].sigma.count > 0);
+}
 
-  // if count_actives doesn't reach 2, g can't contain a red sigma-graph
-  if (count_actives < 2) return false;
+std::set<std::pair<size_t, size_t>> red_sigmagraph_pairs(const RBGraph& g) {
+  update_sigma(g);
 
-  std::tie(v, v_end) = vertices(g);
-  for (; v != v_end; ++v) {
-    if (!is_active(*v, g)) continue;
-    // for each active character
+  const auto& sigma = g[boost::graph_bundle].sigma;
+  const auto n = sigma.n_characters;
 
-    for (auto u = std::next(v); u != v_end; ++u) {
-      if (!is_active(*u, g)) continue;
-      // for each active character coming after *v
+  std::set<std::pair<size_t, size_t>> output;
 
-      // check if characters *v and *u are part of a red sigma-graph
-      if (has_red_sigmapath(*v, *u, g)) return true;
+  for (size_t c0 = 0; c0 < n; ++c0) {
+    for (size_t c1 = c0 + 1; c1 < n; ++c1) {
+      if (sigma.pairs[c0 * n + c1]) output.emplace(c0, c1);
     }
   }
 
-  return false;
+  return output;
 }
 
 bool has_red_sigmapath(const RBVertex c0, const RBVertex c1, const RBGraph& g) {
@@ -819,73 +1999,93 @@ bool has_red_sigmapath(const RBVertex c0, const RBVertex c1, const RBGraph& g) {
 }
 
 void change_char_type(const RBVertex v, RBGraph& g) {
+  auto& sigma = g[boost::graph_bundle].sigma;
+
   RBOutEdgeIter e, e_end;
   std::tie(e, e_end) = out_edges(v, g);
+
+  if (sigma.valid && g[v].id >= sigma.n_characters) sigma.valid = false;
+
+  if (sigma.valid) {
+    // the red edges of v are turned black
+    for (; e != e_end; ++e) {
+      if (is_red(*e, g)) update_shared(target(*e, g), v, false, g);
+    }
+
+    std::tie(e, e_end) = out_edges(v, g);
+  }
   
-  for(; e != e_end; ++e)
-    if(is_red(*e, g))
+  for(; e != e_end; ++e) {
+    const auto u = target(*e, g);
+
+    if(is_red(*e, g)) {
       g[*e].color = Color::black;
-    else
+      g[u].red_degree--;
+      g[u].black_degree++;
+    } else {
       g[*e].color = Color::red;
+      g[u].black_degree--;
+      g[u].red_degree++;
+    }
+  }
+
+  std::swap(g[v].red_degree, g[v].black_degree);
+
+  if (sigma.valid) {
+    // the black edges of v have been turned red
+    std::tie(e, e_end) = out_edges(v, g);
+    for (; e != e_end; ++e) {
+      if (is_red(*e, g)) update_shared(target(*e, g), v, true, g);
+    }
+
+    touch_sigma_character(v, g);
+  }
+
+  auto* const journal = recording(g);
+
+  if (journal)
+    journal->changes.push_back({RBChange::Kind::change_char_type, v});
 }
 
-std::set<std::string> active_characters(const RBGraph& g) {
-  std::set<std::string> ac;
+std::set<size_t> active_characters(const RBGraph& g) {
+  std::set<size_t> ac;
   RBVertexIter v, v_end;
   
   std::tie(v, v_end) = vertices(g);
   while(v != v_end) {
     if(is_active(*v, g))
-      ac.insert(g[*v].name);
+      ac.insert(g[*v].id);
     v++;
   }
   return ac;
 }
 
-std::set<std::string> specie_active_characters(const RBVertex v, const RBGraph& g) {
-  std::set<std::string> s{};
+std::set<size_t> specie_active_characters(const RBVertex v, const RBGraph& g) {
+  std::set<size_t> s{};
   if(is_character(v, g)) return s;
 
   RBOutEdgeIter oe, oe_end;
   std::tie(oe, oe_end) = out_edges(v, g);
   while(oe != oe_end) {
     if(g[*oe].color == Color::red)
-      s.insert(g[target(*oe, g)].name);
+      s.insert(g[target(*oe, g)].id);
     oe++;
   }
   return s;
 
 }
 
-std::set<std::string> comp_active_characters(const RBVertex v, const RBGraph& g) {
+std::set<size_t> comp_active_characters(const RBVertex v, const RBGraph& g) {
   if (is_character(v, g)) return {};
+  std::set<size_t> ac;
 
-  RBVertexIMap index_map, comp_map;
-  RBVertexIAssocMap index_assocmap(index_map), comp_assocmap(comp_map);
-
-  // fill vertex index map
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (size_t index = 0; u != u_end; ++u, ++index) {
-    boost::put(index_assocmap, *u, index);
-  }
-
-  // build the components map
-  boost::connected_components(g, comp_assocmap,
-                              boost::vertex_index_map(index_assocmap));
-  return comp_active_characters(v, g, comp_map);
-}
-
-std::set<std::string> comp_active_characters(const RBVertex v, const RBGraph& g, const RBVertexIMap& c_map) {
-  if (is_character(v, g)) return {};
-  std::set<std::string> ac;
+  const auto c = component(v, g);
 
-  RBVertexIter u, u_end;
-  std::tie(u, u_end) = vertices(g);
-  for (; u != u_end; ++u) {
-    if(!is_active(*u, g) || c_map.at(v) != c_map.at(*u)) continue; 
-    ac.insert(g[*u].name);
+  for (const auto u : vertex_map(Type::character, g)) {
+    if (u == RBGraph::null_vertex()) continue;
+    if(!is_active(u, g) || component(u, g) != c) continue; 
+    ac.insert(g[u].id);
   }
 
   return ac;
-}
\ No newline at end of file
+}
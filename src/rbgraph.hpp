@@ -1,8 +1,10 @@
 #ifndef RBGRAPH_HPP
 #define RBGRAPH_HPP
 
+#include <boost/dynamic_bitset.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <iostream>
+#include <set>
 #include "globals.hpp"
 
 //=============================================================================
@@ -18,9 +20,9 @@ typedef boost::adjacency_list_traits<boost::listS,       // OutEdgeList
     RBTraits;
 
 /**
-  Map of strings and vertices (red-black graph)
+  Map of IDs and vertices (red-black graph), indexed by ID
 */
-typedef std::map<std::string, RBTraits::vertex_descriptor> RBVertexNameMap;
+typedef std::vector<RBTraits::vertex_descriptor> RBVertexIDMap;
 
 //=============================================================================
 // Data structures
@@ -63,10 +65,101 @@ struct RBEdgeProperties {
 
   A red-black graph on a set S of species and a set C of characters, is a
   bipartite graph whose vertex set is S ∪ C.
+  Species and characters are identified by a dense integer ID (one sequence
+  for each type), the vertex name can be retrieved with get_name.
+  The number of red and black edges incident on the vertex is kept up to date
+  by add_edge, remove_edge, clear_vertex and change_char_type, so checks on the
+  color of the edges of a character don't need to visit them.
 */
 struct RBVertexProperties {
-  std::string name{};  ///< Vertex name
-  Type type{};         ///< Vertex type (Character or Species)
+  size_t id{};  ///< Vertex ID (Species ID or Character ID)
+  Type type{};  ///< Vertex type (Character or Species)
+
+  size_t red_degree{};    ///< Number of red edges incident on the vertex
+  size_t black_degree{};  ///< Number of black edges incident on the vertex
+};
+
+/**
+  @brief Struct used to keep track of the connected components of a red-black
+         graph
+
+  Components are identified by a label, which is stored for each species and
+  character ID.
+  The labels are kept up to date lazily: adding or removing edges only marks
+  the components involved as dirty and records the endpoints of the edges
+  (seeds); the next query relabels the dirty components by visiting the graph
+  from the seeds, so only the components that changed are visited again.
+  Labels are not reused: the pieces of a dirty component get new labels.
+*/
+struct RBComponents {
+  bool valid{};  ///< False if the whole graph has to be labeled again
+
+  std::vector<size_t> species{};     ///< Component of each species
+  std::vector<size_t> characters{};  ///< Component of each character
+
+  std::vector<size_t> num_species{};  ///< Number of species in each component
+  std::vector<std::pair<Type, size_t>> first{};  ///< First vertex (type, ID)
+                                                 ///< of each component
+  std::vector<bool> alive{};  ///< True if the component is in the graph
+  std::vector<bool> dirty{};  ///< True if the component has to be labeled
+                              ///< again
+
+  std::vector<size_t> dirty_list{};  ///< Components to label again
+  std::vector<std::pair<Type, size_t>> seeds{};  ///< Vertices (type, ID) to
+                                                 ///< label again from
+  size_t count{};  ///< Number of components in the graph
+};
+
+/**
+  @brief Struct used to keep track of the red Σ-graphs of a red-black graph
+
+  Two active characters c0 and c1 induce a red Σ-graph if they share a
+  species through red edges, and each of them has a red edge to a species
+  that is not adjacent to the other one. Since active characters are only
+  incident on red edges, this is the case if the number of species shared by
+  c0 and c1 is greater than 0 and less than the red degree of both.
+  The number of species shared by each pair of characters is kept up to date
+  by add_edge, remove_edge, change_char_type and rollback, which also mark
+  the characters whose edges changed as dirty: the next query checks again
+  only the pairs of the dirty characters.
+  Pairs are stored in n x n matrices (row-major), where n is the number of
+  character IDs when the counters are built. The counters are built by the
+  first query, so graphs that are never queried don't pay for them, and
+  they're built again if a character with a greater ID gets edges.
+*/
+struct RBSigma {
+  bool valid{};  ///< False if the counters have to be built
+
+  size_t n_characters{};         ///< Number of character IDs (n)
+  std::vector<size_t> shared{};  ///< Number of shared species of each pair
+  std::vector<bool> pairs{};     ///< True if the pair (c0 < c1) induces a
+                                 ///< red Σ-graph
+  size_t count{};                ///< Number of pairs that induce a red
+                                 ///< Σ-graph
+
+  std::vector<bool> dirty{};         ///< True if the character is dirty
+  std::vector<size_t> dirty_list{};  ///< Dirty characters
+};
+
+/**
+  Undo journal of a red-black graph (defined in rbgraph.cpp)
+*/
+struct RBJournal;
+
+/**
+  @brief Struct used to own the undo journal of a red-black graph
+
+  The journal is created by the first checkpoint taken on the graph.
+  It records changes to the vertices and edges of that graph only, so copies
+  of the graph don't share it: copying the holder results in an empty holder.
+*/
+struct RBJournalHolder {
+  RBJournalHolder();
+  RBJournalHolder(const RBJournalHolder&);
+  RBJournalHolder& operator=(const RBJournalHolder&);
+  ~RBJournalHolder();
+
+  std::unique_ptr<RBJournal> journal{};  ///< Undo journal
 };
 
 /**
@@ -76,8 +169,17 @@ struct RBGraphProperties {
   size_t num_species{};     ///< Number of species in the graph
   size_t num_characters{};  ///< Number of characters in the graph
 
-  RBVertexNameMap vertex_map{};  ///< Map for vertex names and vertices in the
-                                 ///< graph
+  RBVertexIDMap species_map{};    ///< Map for species IDs and vertices in
+                                  ///< the graph
+  RBVertexIDMap character_map{};  ///< Map for character IDs and vertices in
+                                  ///< the graph
+
+  mutable RBComponents components{};  ///< Connected components of the graph,
+                                      ///< updated when they're queried
+  mutable RBSigma sigma{};  ///< Red Σ-graphs of the graph, built when they're
+                            ///< first queried
+
+  RBJournalHolder journal{};  ///< Changes made since the first checkpoint
 };
 
 //=============================================================================
@@ -157,6 +259,11 @@ typedef boost::associative_property_map<RBVertexMap> RBVertexAssocMap;
 */
 typedef std::vector<std::unique_ptr<RBGraph>> RBGraphVector;
 
+/**
+  Dynamic set of bits, one for each species or character
+*/
+typedef boost::dynamic_bitset<> Bitset;
+
 //=============================================================================
 // Auxiliary structs and classes
 
@@ -225,6 +332,17 @@ void remove_vertex(const RBVertex v, RBGraph& g);
 */
 void remove_vertex(const std::string& name, RBGraph& g);
 
+/**
+  @brief Add vertex with \e id and \e type to \e g
+
+  @param[in]     id   ID
+  @param[in]     type Type
+  @param[in,out] g    Red-black graph
+
+  @return Vertex descriptor for the new vertex
+*/
+RBVertex add_vertex(const size_t id, const Type type, RBGraph& g);
+
 /**
   @brief Add vertex with \e name and \e type to \e g
 
@@ -283,6 +401,22 @@ inline std::pair<RBEdge, bool> add_edge(const RBVertex u, const RBVertex v,
   return add_edge(u, v, Color::black, g);
 }
 
+/**
+  @brief Remove edge \e e from \e g
+
+  @param[in]     e Edge
+  @param[in,out] g Red-black graph
+*/
+void remove_edge(const RBEdge e, RBGraph& g);
+
+/**
+  @brief Remove all edges incident on \e v from \e g
+
+  @param[in]     v Vertex
+  @param[in,out] g Red-black graph
+*/
+void clear_vertex(const RBVertex v, RBGraph& g);
+
 //=============================================================================
 // General functions
 
@@ -331,25 +465,68 @@ inline const size_t num_characters(const RBGraph& g) {
 }
 
 /**
-  @brief Return the map in \e g
+  @brief Return the map of vertices of type \e type in \e g
 
-  @param[in] g Red-black graph
+  @param[in] type Type
+  @param[in] g    Red-black graph
 
-  @return Reference to the map in \e g
+  @return Reference to the map of vertices of type \e type in \e g
 */
-inline RBVertexNameMap& vertex_map(RBGraph& g) {
-  return g[boost::graph_bundle].vertex_map;
+inline RBVertexIDMap& vertex_map(const Type type, RBGraph& g) {
+  if (type == Type::species) return g[boost::graph_bundle].species_map;
+
+  return g[boost::graph_bundle].character_map;
 }
 
 /**
-  @brief Return the map (const) in \e g
+  @brief Return the map (const) of vertices of type \e type in \e g
 
+  @param[in] type Type
+  @param[in] g    Red-black graph
+
+  @return Constant reference to the map of vertices of type \e type in \e g
+*/
+inline const RBVertexIDMap& vertex_map(const Type type, const RBGraph& g) {
+  if (type == Type::species) return g[boost::graph_bundle].species_map;
+
+  return g[boost::graph_bundle].character_map;
+}
+
+/**
+  @brief Return the ID of the vertex name \e name of type \e type
+
+  Vertex names are interned: the first time a name is seen it's assigned the
+  next free ID of its type, which is returned for the same name from then on.
+  Names are only needed to read and print graphs, the algorithm works on IDs.
+  Names are shared by all threads, interning is thread-safe.
+
+  @param[in] name Vertex name
+  @param[in] type Type
+
+  @return Vertex ID
+*/
+size_t intern_name(const std::string& name, const Type type);
+
+/**
+  @brief Return the name of the vertex with \e id and \e type
+
+  @param[in] id   Vertex ID
+  @param[in] type Type
+
+  @return Vertex name
+*/
+const std::string& get_name(const size_t id, const Type type);
+
+/**
+  @brief Return the name of \e v in \e g
+
+  @param[in] v Vertex
   @param[in] g Red-black graph
 
-  @return Constant map in \e g
+  @return Vertex name
 */
-inline const RBVertexNameMap vertex_map(const RBGraph& g) {
-  return g[boost::graph_bundle].vertex_map;
+inline const std::string& get_name(const RBVertex v, const RBGraph& g) {
+  return get_name(g[v].id, g[v].type);
 }
 
 /**
@@ -375,17 +552,38 @@ void remove_vertex_if(const RBVertex v, Predicate predicate, RBGraph& g) {
 */
 void build_vertex_map(RBGraph& g);
 
+/**
+  @brief Return the vertex descriptor of the vertex with \e id and \e type
+         in \e g
+
+  Throws std::out_of_range if there is no such vertex in \e g.
+
+  @param[in] id   Vertex ID
+  @param[in] type Type
+  @param[in] g    Red-black graph
+
+  @return Vertex
+*/
+inline RBVertex get_vertex(const size_t id, const Type type,
+                           const RBGraph& g) {
+  const auto v = vertex_map(type, g).at(id);
+
+  if (v == RBGraph::null_vertex()) throw std::out_of_range("no such vertex");
+
+  return v;
+}
+
 /**
   @brief Return the vertex descriptor of the vertex \e name in \e g
 
+  Throws std::out_of_range if there is no such vertex in \e g.
+
   @param[in] name Vertex name
   @param[in] g    Red-black graph
 
   @return Vertex
 */
-inline const RBVertex get_vertex(const std::string& name, const RBGraph& g) {
-  return vertex_map(g).at(name);
-}
+RBVertex get_vertex(const std::string& name, const RBGraph& g);
 
 /**
   @brief Copy graph \e g to graph \e g_copy
@@ -405,7 +603,52 @@ void copy_graph(const RBGraph& g, RBGraph& g_copy);
 void copy_graph(const RBGraph& g, RBGraph& g_copy, RBVertexMap& v_map);
 
 /**
-  @brief Overloading of operator<< for RBGraph
+  @brief Start recording the changes made to \e g, so that they can be undone
+         with rollback
+
+  Speculative changes (e.g. testing a chain) can be made on \e g itself and
+  then rolled back, in time proportional to the number of changes, instead of
+  being made on a copy of \e g.
+  Checkpoints can be nested: rolling back to a checkpoint also discards the
+  checkpoints taken after it.
+
+  @param[in,out] g Red-black graph
+
+  @return Checkpoint
+*/
+size_t checkpoint(RBGraph& g);
+
+/**
+  @brief Undo the changes made to \e g since \e checkpoint, in reverse order
+
+  Removed vertices and edges are put back in their original position, so
+  vertex and edge descriptors of \e g taken before \e checkpoint are valid
+  again and vertices and edges are visited in the same order as before.
+
+  @param[in]     checkpoint Checkpoint
+  @param[in,out] g          Red-black graph
+*/
+void rollback(const size_t checkpoint, RBGraph& g);
+
+/**
+  @brief Write the adjacency lists of \e g to \e os, one vertex for each line
+
+  Species are written before characters, and vertices and edges are sorted
+  by the number in their names (e.g. s2 before s10).
+  The whole dump is built in a single buffer and then written, unless
+  \e stream is true: then each line is written as soon as it's built, so the
+  dump is never held in memory.
+
+  @param[in,out] os     Output stream
+  @param[in]     g      Red-black graph
+  @param[in]     stream True if each line must be written as soon as it's
+                        built
+*/
+void print_adjacency(std::ostream& os, const RBGraph& g,
+                     const bool stream = false);
+
+/**
+  @brief Overloading of operator<< for RBGraph (see print_adjacency)
 
   @param[in] os Output stream
   @param[in] g  Red-black graph
@@ -419,11 +662,45 @@ std::ostream& operator<<(std::ostream& os, const RBGraph& g);
 /**
   @brief Read from \e filename into \e g
 
+  The format of \e filename, text or binary (see write_graph), is detected
+  from its first bytes.
+
   @param[in]  filename Filename
   @param[out] g        Red-black graph
 */
 void read_graph(const std::string& filename, RBGraph& g);
 
+/**
+  @brief Read from the \e size bytes at \e data, the contents of an input file
+         in the text or binary format, into \e g
+
+  @param[in]  data Contents of the input file
+  @param[in]  size Size of the input file
+  @param[out] g    Red-black graph
+*/
+void read_graph(const char* data, const size_t size, RBGraph& g);
+
+/**
+  @brief Write \e g to \e filename, in the text or in the binary format
+
+  Species and characters are the rows and columns of the matrix, in the order
+  of their IDs, and characters with red edges are written as active.
+  The binary format (all integers are little-endian) is made of:
+  - "PPPB" and the format version (4 bytes);
+  - number of species, number of characters and number of active characters
+    (8 bytes each);
+  - FNV-1a hash (8 bytes) of the rest of the file;
+  - active characters (8 bytes each);
+  - one row for each species, with one bit for each character (bit i % 8 of
+    byte i / 8), padded to a whole byte.
+
+  @param[in] filename Filename
+  @param[in] g        Red-black graph
+  @param[in] binary   True to use the binary format
+*/
+void write_graph(const std::string& filename, const RBGraph& g,
+                 const bool binary = false);
+
 //=============================================================================
 // Algorithm functions
 
@@ -475,6 +752,30 @@ inline bool is_red(const RBEdge e, const RBGraph& g) {
   return (g[e].color == Color::red);
 }
 
+/**
+  @brief Return the number of red edges incident on \e v in \e g
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+
+  @return Number of red edges incident on \e v
+*/
+inline size_t red_degree(const RBVertex v, const RBGraph& g) {
+  return g[v].red_degree;
+}
+
+/**
+  @brief Return the number of black edges incident on \e v in \e g
+
+  @param[in] v Vertex
+  @param[in] g Red-black graph
+
+  @return Number of black edges incident on \e v
+*/
+inline size_t black_degree(const RBVertex v, const RBGraph& g) {
+  return g[v].black_degree;
+}
+
 /**
   @brief Check if \e v is active in \e g
 
@@ -522,44 +823,59 @@ void remove_singletons(RBGraph& g);
 inline bool is_empty(const RBGraph& g) { return (num_vertices(g) == 0); }
 
 /**
-  @brief Check if \e v is free in \e g
+  @brief Return the number of connected components of \e g
 
-  A vertex is free in a red-black graph if it's an active character that is
-  connected to all species of the graph by red dges.
+  @param[in] g Red-black graph
+
+  @return Number of connected components of \e g
+*/
+size_t num_components(const RBGraph& g);
+
+/**
+  @brief Return the connected component of \e v in \e g
 
   @param[in] v Vertex
   @param[in] g Red-black graph
 
-  @return True if \e v is free in \e g
+  @return Label of the connected component of \e v
 */
-bool is_free(const RBVertex v, const RBGraph& g);
+size_t component(const RBVertex v, const RBGraph& g);
 
 /**
-  @brief Check if \e v is free in \e g
+  @brief Return the number of species in the connected component \e c of
+         \e g
 
-  A vertex is free in a red-black graph if it's an active character that is
-  connected to all species of the graph by red dges.
+  @param[in] c Component label
+  @param[in] g Red-black graph
+
+  @return Number of species in \e c
+*/
+size_t num_component_species(const size_t c, const RBGraph& g);
 
-  @param[in] v     Vertex
-  @param[in] g     Red-black graph
-  @param[in] c_map Components map of \e g
+/**
+  @brief Return the connected components of \e g
 
-  @return True if \e v is free in \e g
+  Components are sorted by their first vertex, species before characters,
+  which is the order boost::connected_components would number them in.
+
+  @param[in] g Red-black graph
+
+  @return Labels of the connected components of \e g
 */
-bool is_free(const RBVertex v, const RBGraph& g, const RBVertexIMap& c_map);
+std::vector<size_t> components(const RBGraph& g);
 
 /**
-  @brief Check if \e v is universal in \e g
+  @brief Check if \e v is free in \e g
 
-  A vertex is free in a red-black graph if it's an inactive character that is
-  connected to all species of the graph by black dges.
+  A vertex is free in a red-black graph if it's an active character that is
+  connected to all species of the graph by red dges.
 
   @param[in] v Vertex
   @param[in] g Red-black graph
 
-  @return True if \e v is universal in \e g
+  @return True if \e v is free in \e g
 */
-bool is_universal(const RBVertex v, const RBGraph& g);
+bool is_free(const RBVertex v, const RBGraph& g);
 
 /**
   @brief Check if \e v is universal in \e g
@@ -567,14 +883,12 @@ bool is_universal(const RBVertex v, const RBGraph& g);
   A vertex is free in a red-black graph if it's an inactive character that is
   connected to all species of the graph by black dges.
 
-  @param[in] v     Vertex
-  @param[in] g     Red-black graph
-  @param[in] c_map Components map of \e g
+  @param[in] v Vertex
+  @param[in] g Red-black graph
 
   @return True if \e v is universal in \e g
 */
-bool is_universal(const RBVertex v, const RBGraph& g,
-                  const RBVertexIMap& c_map);
+bool is_universal(const RBVertex v, const RBGraph& g);
 
 /**
   @brief Build the red-black subgraphs of \e g.
@@ -590,23 +904,6 @@ bool is_universal(const RBVertex v, const RBGraph& g,
 */
 RBGraphVector connected_components(const RBGraph& g);
 
-/**
-  @brief Build the red-black subgraphs of \e g.
-         Each subgraph is a copy of the respective connected component
-
-  If the graph \e g is connected, RBGraphVector will be of size 1, but the
-  unique_ptr will be empty. This is because the purpose of the functions is to
-  build the subgraphs, not copy the whole graph when it isn't needed.
-
-  @param[in] g       Red-black graph
-  @param[in] c_map   Components map of \e g
-  @param[in] c_count Number of connected components of \e g
-
-  @return components Vector of unique pointers to each subgraph
-*/
-RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
-                                   const size_t c_count);
-
 /**
   @brief Build the list of maximal characters of \e g
 
@@ -618,10 +915,13 @@ RBGraphVector connected_components(const RBGraph& g, const RBVertexIMap& c_map,
   character c' of the graph.
   Moreover two characters c, c' overlap if they share a common species
   but neither is included in the other.
+  Among characters with the same set of species only the first one is
+  maximal. The sets are compared as bitsets, visiting the characters by number
+  of species in descending order.
 
   @param[in] g Red-black graph
 
-  @return Maximal characters (vertices) of \e g
+  @return Maximal characters (vertices) of \e g, in the same order as in \e g
 */
 const std::list<RBVertex> maximal_characters(const RBGraph& g);
 
@@ -646,6 +946,9 @@ RBGraph maximal_reducible_graph(const RBGraph& g, const bool active = false);
 
   A red-black graph containing a red Σ-graph cannot be reduced to an empty
   graph by a c-reduction.
+  The pairs of characters that induce a red Σ-graph are kept up to date as
+  the edges of \e g change (see RBSigma), so the check takes constant time
+  after the first one.
 
   @param[in] g Red-black graph
 
@@ -653,6 +956,18 @@ RBGraph maximal_reducible_graph(const RBGraph& g, const bool active = false);
 */
 bool has_red_sigmagraph(const RBGraph& g);
 
+/**
+  @brief Return the pairs of characters of \e g that induce a red Σ-graph
+
+  Used to find the characters responsible when has_red_sigmagraph turns
+  true after a realization.
+
+  @param[in] g Red-black graph
+
+  @return Pairs of character IDs (ascending)
+*/
+std::set<std::pair<size_t, size_t>> red_sigmagraph_pairs(const RBGraph& g);
+
 /**
   @brief Check if \e g contains a red Σ-graph with characters \e c0 and \e c1
 
@@ -683,9 +998,9 @@ void change_char_type(const RBVertex v, RBGraph& g);
   @param[in] v specie in the graph
   @param[in] g Red-black graph
 
-  @return Set of active characters (only the names)
+  @return Set of active characters (only the IDs)
 **/  
-std::set<std::string> specie_active_characters(const RBVertex v, const RBGraph& g);
+std::set<size_t> specie_active_characters(const RBVertex v, const RBGraph& g);
 
 
 
@@ -694,9 +1009,9 @@ std::set<std::string> specie_active_characters(const RBVertex v, const RBGraph&
 
   @param[in] g Red-black graph
  
-  @return Set of active characters (only the names)
+  @return Set of active characters (only the IDs)
 **/
-std::set<std::string> active_characters(const RBGraph& g);
+std::set<size_t> active_characters(const RBGraph& g);
 
 /**
   @brief Given a red-black graph and a specie, return the active characters included in the component that includes the specie
@@ -704,18 +1019,8 @@ std::set<std::string> active_characters(const RBGraph& g);
   @param[in] v Specie
   @param[in] g Red-black graph
 
-  @return Set of active characters (only the names)
+  @return Set of active characters (only the IDs)
 **/
-std::set<std::string> comp_active_characters(const RBVertex v, const RBGraph& g);
+std::set<size_t> comp_active_characters(const RBVertex v, const RBGraph& g);
 
-/**
-  @brief Given a red-black graph and a specie, return the active characters included in the component that includes the specie
-
-  @param[in] v Specie
-  @param[in] g Red-black graph
-  @param[in] c_map Map of vertices and connected components
-
-  @return Set of active characters (only the names)
-**/
-std::set<std::string> comp_active_characters(const RBVertex v, const RBGraph& g, const RBVertexIMap& c_map);
 #endif  // RBGRAPH_HPP
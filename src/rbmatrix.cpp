@@ -0,0 +1,382 @@
+#include "rbmatrix.hpp"
+#include "stats.hpp"
+
+// the red Σ-graph kernel is compiled for AVX-512 and AVX2 too, the variant
+// supported by the CPU is chosen when the program is loaded
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SIGMA_KERNEL \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+
+#ifndef SIGMA_KERNEL
+#define SIGMA_KERNEL
+#endif
+
+/**
+  @brief Number of characters in a tile of the red Σ-graph kernel, so that
+         the rows of two tiles stay in the L1 cache
+*/
+static constexpr size_t sigma_tile = 32;
+
+//=============================================================================
+// Boost functions (overloading)
+
+void add_edge(const size_t s, const size_t c, const Color color, RBMatrix& m) {
+  if (color == Color::red) {
+    m.red[s].set(c);
+    m.red_t[c].set(s);
+  } else {
+    m.black[s].set(c);
+    m.black_t[c].set(s);
+  }
+}
+
+void remove_edge(const size_t s, const size_t c, RBMatrix& m) {
+  m.black[s].reset(c);
+  m.red[s].reset(c);
+  m.black_t[c].reset(s);
+  m.red_t[c].reset(s);
+}
+
+void clear_character(const size_t c, RBMatrix& m) {
+  const Bitset adj = m.black_t[c] | m.red_t[c];
+
+  for (auto s = adj.find_first(); s != Bitset::npos; s = adj.find_next(s)) {
+    // for each species adjacent to c
+    m.black[s].reset(c);
+    m.red[s].reset(c);
+  }
+
+  m.black_t[c].reset();
+  m.red_t[c].reset();
+}
+
+//=============================================================================
+// Red Σ-graph kernel
+
+/**
+  @brief Check if any two of the \e n_rows rows of red edges in \e rows
+         induce a red Σ-graph
+
+  Rows are the red edges of active characters, which have no black edges:
+  the characters c0 and c1 induce a red Σ-graph if R(c0) & R(c1),
+  R(c0) & ~R(c1) and R(c1) & ~R(c0) are all non-empty.
+  Pairs are checked in tiles of sigma_tile x sigma_tile rows, each pair with
+  a branch-free loop over its blocks that the compiler vectorizes.
+
+  @param[in] rows     Rows of \e n_blocks blocks each
+  @param[in] n_rows   Number of rows
+  @param[in] n_blocks Number of blocks in each row
+
+  @return True if two rows induce a red Σ-graph
+*/
+SIGMA_KERNEL
+static bool has_red_sigmapair(const Bitset::block_type* rows,
+                              const size_t n_rows, const size_t n_blocks) {
+  for (size_t ti = 0; ti < n_rows; ti += sigma_tile) {
+    const auto ti_end = std::min(ti + sigma_tile, n_rows);
+
+    for (size_t tj = ti; tj < n_rows; tj += sigma_tile) {
+      const auto tj_end = std::min(tj + sigma_tile, n_rows);
+
+      for (size_t i = ti; i < ti_end; ++i) {
+        const auto* const r0 = rows + i * n_blocks;
+
+        for (size_t j = std::max(i + 1, tj); j < tj_end; ++j) {
+          const auto* const r1 = rows + j * n_blocks;
+
+          Bitset::block_type shared = 0, only0 = 0, only1 = 0;
+
+          for (size_t b = 0; b < n_blocks; ++b) {
+            shared |= r0[b] & r1[b];
+            only0 |= r0[b] & ~r1[b];
+            only1 |= r1[b] & ~r0[b];
+          }
+
+          if (shared && only0 && only1) return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+//=============================================================================
+// General functions
+
+void resize(const size_t n_species, const size_t n_characters, RBMatrix& m) {
+  m.black.assign(n_species, Bitset(n_characters));
+  m.red.assign(n_species, Bitset(n_characters));
+  m.black_t.assign(n_characters, Bitset(n_species));
+  m.red_t.assign(n_characters, Bitset(n_species));
+
+  m.species.resize(n_species);
+  m.species.set();
+  m.characters.resize(n_characters);
+  m.characters.set();
+}
+
+void copy_graph(const RBGraph& g, RBMatrix& m) {
+  stats::count(stats::Counter::copy_graph);
+
+  // IDs are dense, so the matrix is only as big as the largest ID in g
+  resize(vertex_map(Type::species, g).size(),
+         vertex_map(Type::character, g).size(), m);
+
+  // IDs with no vertex in g are missing in m
+  m.species.reset();
+  m.characters.reset();
+
+  RBVertexIter v, v_end;
+  std::tie(v, v_end) = vertices(g);
+  for (; v != v_end; ++v) {
+    if (is_species(*v, g))
+      m.species.set(g[*v].id);
+    else
+      m.characters.set(g[*v].id);
+  }
+
+  for (std::tie(v, v_end) = vertices(g); v != v_end; ++v) {
+    if (!is_species(*v, g)) continue;
+    // for each species, copy its edges
+
+    RBOutEdgeIter e, e_end;
+    std::tie(e, e_end) = out_edges(*v, g);
+    for (; e != e_end; ++e) {
+      add_edge(g[*v].id, g[target(*e, g)].id, g[*e].color, m);
+    }
+  }
+}
+
+void copy_graph(const RBMatrix& m, RBGraph& g) {
+  stats::count(stats::Counter::copy_graph);
+
+  std::vector<RBVertex> species(m.species.size());
+  std::vector<RBVertex> characters(m.characters.size());
+
+  // add species and characters in the same order as they are indexed in m
+  for (auto s = m.species.find_first(); s != Bitset::npos;
+       s = m.species.find_next(s)) {
+    species[s] = add_vertex(s, Type::species, g);
+  }
+
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    characters[c] = add_vertex(c, Type::character, g);
+  }
+
+  for (auto s = m.species.find_first(); s != Bitset::npos;
+       s = m.species.find_next(s)) {
+    // for each species, copy its edges
+    const Bitset adj = m.black[s] | m.red[s];
+
+    for (auto c = adj.find_first(); c != Bitset::npos; c = adj.find_next(c)) {
+      if (m.black[s][c]) add_edge(species[s], characters[c], Color::black, g);
+      if (m.red[s][c]) add_edge(species[s], characters[c], Color::red, g);
+    }
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const RBMatrix& m) {
+  // the matrix is printed through its equivalent graph, this is only used for
+  // logging so the copy is not an issue
+  RBGraph g;
+  copy_graph(m, g);
+
+  return os << g;
+}
+
+//=============================================================================
+// Algorithm functions
+
+void remove_singletons(RBMatrix& m) {
+  for (auto s = m.species.find_first(); s != Bitset::npos;
+       s = m.species.find_next(s)) {
+    if (m.black[s].none() && m.red[s].none()) m.species.reset(s);
+  }
+
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    if (m.black_t[c].none() && m.red_t[c].none()) m.characters.reset(c);
+  }
+}
+
+size_t connected_components(const RBMatrix& m, RBMatrixComponents& comps) {
+  const auto n_species = m.species.size();
+  const auto n_characters = m.characters.size();
+
+  comps.species.assign(n_species, 0);
+  comps.characters.assign(n_characters, 0);
+  comps.num_species.clear();
+
+  // species and characters that have not been reached yet
+  Bitset species = m.species;
+  Bitset characters = m.characters;
+
+  size_t c_count = 0;
+
+  for (auto s = species.find_first(); s != Bitset::npos;
+       s = species.find_first()) {
+    // for each species that is not part of a component yet, visit the
+    // component one layer at a time: each layer is the set of vertices that
+    // are adjacent to the previous one and have not been reached yet
+    Bitset comp_s(n_species), layer_s(n_species);
+    Bitset comp_c(n_characters), layer_c(n_characters);
+
+    layer_s.set(s);
+
+    while (layer_s.any()) {
+      comp_s |= layer_s;
+      species -= layer_s;
+
+      layer_c.reset();
+      for (auto u = layer_s.find_first(); u != Bitset::npos;
+           u = layer_s.find_next(u)) {
+        layer_c |= m.black[u];
+        layer_c |= m.red[u];
+      }
+      layer_c &= characters;
+
+      comp_c |= layer_c;
+      characters -= layer_c;
+
+      layer_s.reset();
+      for (auto c = layer_c.find_first(); c != Bitset::npos;
+           c = layer_c.find_next(c)) {
+        layer_s |= m.black_t[c];
+        layer_s |= m.red_t[c];
+      }
+      layer_s &= species;
+    }
+
+    for (auto u = comp_s.find_first(); u != Bitset::npos;
+         u = comp_s.find_next(u)) {
+      comps.species[u] = c_count;
+    }
+
+    for (auto c = comp_c.find_first(); c != Bitset::npos;
+         c = comp_c.find_next(c)) {
+      comps.characters[c] = c_count;
+    }
+
+    comps.num_species.push_back(comp_s.count());
+
+    c_count++;
+  }
+
+  // characters without species are components on their own
+  for (auto c = characters.find_first(); c != Bitset::npos;
+       c = characters.find_next(c)) {
+    comps.characters[c] = c_count;
+    comps.num_species.push_back(0);
+
+    c_count++;
+  }
+
+  return c_count;
+}
+
+bool is_free(const size_t c, const RBMatrix& m,
+             const RBMatrixComponents& comps) {
+  if (!is_active(c, m)) return false;
+
+  return (m.red_t[c].count() == comps.num_species[comps.characters[c]]);
+}
+
+bool is_universal(const size_t c, const RBMatrix& m,
+                  const RBMatrixComponents& comps) {
+  if (!is_inactive(c, m)) return false;
+
+  return (m.black_t[c].count() == comps.num_species[comps.characters[c]]);
+}
+
+RBMatrixVector connected_components(const RBMatrix& m,
+                                    const RBMatrixComponents& comps,
+                                    const size_t c_count) {
+  RBMatrixVector components;
+
+  // resize subgraph components
+  components.resize(c_count);
+
+  if (c_count <= 1) {
+    // graph is connected
+    for (auto& component : components) {
+      component = std::make_unique<RBMatrix>();
+    }
+
+    return components;
+  }
+  // graph is disconnected
+
+  // each component is a copy of m where only its own vertices are kept
+  for (size_t i = 0; i < c_count; ++i) {
+    components[i] = std::make_unique<RBMatrix>(m);
+  }
+
+  for (auto s = m.species.find_first(); s != Bitset::npos;
+       s = m.species.find_next(s)) {
+    for (size_t i = 0; i < c_count; ++i) {
+      if (comps.species[s] != i) components[i]->species.reset(s);
+    }
+  }
+
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    for (size_t i = 0; i < c_count; ++i) {
+      if (comps.characters[c] != i) components[i]->characters.reset(c);
+    }
+  }
+
+  if (LOGGING(verbose)) {
+    // verbosity enabled
+    *logging::stream << "Connected components: " << c_count << std::endl;
+
+    for (const auto& component : components) {
+      *logging::stream << *component.get() << std::endl << std::endl;
+    }
+  }
+
+  return components;
+}
+
+bool has_red_sigmagraph(const RBMatrix& m) {
+  stats::count(stats::Counter::sigma_checks);
+
+  std::vector<size_t> actives;
+
+  for (auto c = m.characters.find_first(); c != Bitset::npos;
+       c = m.characters.find_next(c)) {
+    if (is_active(c, m)) actives.push_back(c);
+  }
+
+  // if there are less than 2 active characters, m can't contain a red
+  // sigma-graph
+  if (actives.size() < 2) return false;
+
+  // pack the red edges of the active characters in one block-aligned matrix,
+  // so that every pair can be checked with plain word-wise operations
+  const auto n_blocks = m.red_t[actives.front()].num_blocks();
+  std::vector<Bitset::block_type> rows(actives.size() * n_blocks);
+
+  for (size_t i = 0; i < actives.size(); ++i) {
+    boost::to_block_range(m.red_t[actives[i]], rows.begin() + i * n_blocks);
+  }
+
+  return has_red_sigmapair(rows.data(), actives.size(), n_blocks);
+}
+
+bool has_red_sigmapath(const size_t c0, const size_t c1, const RBMatrix& m) {
+  // c0 and c1 must share a species through red edges (junction)
+  if (!m.red_t[c0].intersects(m.red_t[c1])) return false;
+
+  // c0 must have a red edge to a species that is not adjacent to c1
+  if (m.red_t[c0].is_subset_of(m.black_t[c1] | m.red_t[c1])) return false;
+
+  // c1 must have a red edge to a species that is not adjacent to c0
+  if (m.red_t[c1].is_subset_of(m.black_t[c0] | m.red_t[c0])) return false;
+
+  return true;
+}
@@ -0,0 +1,317 @@
+#ifndef RBMATRIX_HPP
+#define RBMATRIX_HPP
+
+#include "rbgraph.hpp"
+
+//=============================================================================
+// Data structures
+
+/**
+  @brief Struct used to represent a red-black graph as a pair of bit-matrices
+
+  Species are the rows and characters are the columns of both matrices, each
+  one indexed by its ID: the bit (s, c) of the black (red) matrix is set if
+  there is a black (red) edge between the species s and the character c.
+  Each matrix is also stored transposed, so that both the characters of a
+  species and the species of a character can be accessed as a single row of
+  bits.
+  Vertices are never removed from the matrices, they are only marked as
+  missing in \e species or \e characters.
+*/
+struct RBMatrix {
+  std::vector<Bitset> black{};    ///< Black edges of each species
+  std::vector<Bitset> red{};      ///< Red edges of each species
+  std::vector<Bitset> black_t{};  ///< Black edges of each character
+  std::vector<Bitset> red_t{};    ///< Red edges of each character
+
+  Bitset species{};     ///< Species in the graph
+  Bitset characters{};  ///< Characters in the graph
+};
+
+/**
+  @brief Struct used to represent the connected components of a bit-matrix
+*/
+struct RBMatrixComponents {
+  std::vector<size_t> species{};     ///< Component of each species
+  std::vector<size_t> characters{};  ///< Component of each character
+  std::vector<size_t> num_species{};  ///< Number of species in each component
+};
+
+//=============================================================================
+// Typedefs used for readabily
+
+/**
+  Vector of unique pointers to red-black bit-matrices
+*/
+typedef std::vector<std::unique_ptr<RBMatrix>> RBMatrixVector;
+
+//=============================================================================
+// Boost functions (overloading)
+
+/**
+  @brief Add edge between the species \e s and the character \e c with
+         \e color to \e m
+
+  @param[in]     s     Species index
+  @param[in]     c     Character index
+  @param[in]     color Color
+  @param[in,out] m     Red-black bit-matrix
+*/
+void add_edge(const size_t s, const size_t c, const Color color, RBMatrix& m);
+
+/**
+  @brief Remove the edges between the species \e s and the character \e c from
+         \e m
+
+  @param[in]     s Species index
+  @param[in]     c Character index
+  @param[in,out] m Red-black bit-matrix
+*/
+void remove_edge(const size_t s, const size_t c, RBMatrix& m);
+
+/**
+  @brief Remove all the edges incident on the character \e c from \e m
+
+  @param[in]     c Character index
+  @param[in,out] m Red-black bit-matrix
+*/
+void clear_character(const size_t c, RBMatrix& m);
+
+//=============================================================================
+// General functions
+
+/**
+  @brief Return the number of species in \e m
+
+  @param[in] m Red-black bit-matrix
+
+  @return Number of species in \e m
+*/
+inline size_t num_species(const RBMatrix& m) { return m.species.count(); }
+
+/**
+  @brief Return the number of characters in \e m
+
+  @param[in] m Red-black bit-matrix
+
+  @return Number of characters in \e m
+*/
+inline size_t num_characters(const RBMatrix& m) {
+  return m.characters.count();
+}
+
+/**
+  @brief Return the index of the character with \e id in \e m
+
+  Throws std::out_of_range if there is no such character in \e m.
+
+  @param[in] id Character ID
+  @param[in] m  Red-black bit-matrix
+
+  @return Character index
+*/
+inline size_t get_character(const size_t id, const RBMatrix& m) {
+  if (id >= m.characters.size() || !m.characters[id])
+    throw std::out_of_range("no such character");
+
+  return id;
+}
+
+/**
+  @brief Initialize \e m with \e n_species species and \e n_characters
+         characters, and no edges
+
+  @param[in]     n_species    Number of species
+  @param[in]     n_characters Number of characters
+  @param[in,out] m            Red-black bit-matrix
+*/
+void resize(const size_t n_species, const size_t n_characters, RBMatrix& m);
+
+/**
+  @brief Copy graph \e g to bit-matrix \e m
+
+  Species and characters are indexed by their ID.
+
+  @param[in]     g Red-black graph
+  @param[in,out] m Red-black bit-matrix
+*/
+void copy_graph(const RBGraph& g, RBMatrix& m);
+
+/**
+  @brief Copy bit-matrix \e m to graph \e g
+
+  @param[in]     m Red-black bit-matrix
+  @param[in,out] g Red-black graph
+*/
+void copy_graph(const RBMatrix& m, RBGraph& g);
+
+/**
+  @brief Copy bit-matrix \e m to bit-matrix \e m_copy
+
+  @param[in]     m      Red-black bit-matrix
+  @param[in,out] m_copy Red-black bit-matrix
+*/
+inline void copy_graph(const RBMatrix& m, RBMatrix& m_copy) { m_copy = m; }
+
+/**
+  @brief Take a checkpoint of \e m, so that its changes can be undone with
+         rollback
+
+  The checkpoint of a bit-matrix is a copy of it, which only costs a few words
+  for each species and character.
+
+  @param[in] m Red-black bit-matrix
+
+  @return Checkpoint
+*/
+inline RBMatrix checkpoint(const RBMatrix& m) { return m; }
+
+/**
+  @brief Undo the changes made to \e m since \e checkpoint
+
+  @param[in]     checkpoint Checkpoint
+  @param[in,out] m          Red-black bit-matrix
+*/
+inline void rollback(const RBMatrix& checkpoint, RBMatrix& m) {
+  m = checkpoint;
+}
+
+/**
+  @brief Overloading of operator<< for RBMatrix
+
+  The output is the same as the one of the equivalent RBGraph.
+
+  @param[in] os Output stream
+  @param[in] m  Red-black bit-matrix
+
+  @return Updated output stream
+*/
+std::ostream& operator<<(std::ostream& os, const RBMatrix& m);
+
+//=============================================================================
+// Algorithm functions
+
+/**
+  @brief Check if the character \e c is active in \e m
+
+  @param[in] c Character index
+  @param[in] m Red-black bit-matrix
+
+  @return True if \e c is active in \e m
+*/
+inline bool is_active(const size_t c, const RBMatrix& m) {
+  return (m.characters[c] && m.black_t[c].none());
+}
+
+/**
+  @brief Check if the character \e c is inactive in \e m
+
+  @param[in] c Character index
+  @param[in] m Red-black bit-matrix
+
+  @return True if \e c is inactive in \e m
+*/
+inline bool is_inactive(const size_t c, const RBMatrix& m) {
+  return (m.characters[c] && m.red_t[c].none());
+}
+
+/**
+  @brief Remove singleton vertices from \e m
+
+  @param[in,out] m Red-black bit-matrix
+*/
+void remove_singletons(RBMatrix& m);
+
+/**
+  @brief Check if \e m is empty
+
+  @param[in] m Red-black bit-matrix
+
+  @return True if \e m is empty
+*/
+inline bool is_empty(const RBMatrix& m) {
+  return (m.species.none() && m.characters.none());
+}
+
+/**
+  @brief Label the connected components of \e m
+
+  Components are numbered in the same order as boost::connected_components
+  would number them on the equivalent RBGraph: species first, then characters.
+
+  @param[in]  m     Red-black bit-matrix
+  @param[out] comps Connected components of \e m
+
+  @return Number of connected components of \e m
+*/
+size_t connected_components(const RBMatrix& m, RBMatrixComponents& comps);
+
+/**
+  @brief Check if the character \e c is free in \e m
+
+  @param[in] c     Character index
+  @param[in] m     Red-black bit-matrix
+  @param[in] comps Connected components of \e m
+
+  @return True if \e c is free in \e m
+*/
+bool is_free(const size_t c, const RBMatrix& m,
+             const RBMatrixComponents& comps);
+
+/**
+  @brief Check if the character \e c is universal in \e m
+
+  @param[in] c     Character index
+  @param[in] m     Red-black bit-matrix
+  @param[in] comps Connected components of \e m
+
+  @return True if \e c is universal in \e m
+*/
+bool is_universal(const size_t c, const RBMatrix& m,
+                  const RBMatrixComponents& comps);
+
+/**
+  @brief Build the red-black bit-matrices of the connected components of \e m
+
+  If \e m is connected, RBMatrixVector will be of size 1, but the unique_ptr
+  will be empty, like for RBGraph.
+
+  @param[in] m       Red-black bit-matrix
+  @param[in] comps   Connected components of \e m
+  @param[in] c_count Number of connected components of \e m
+
+  @return Vector of unique pointers to each component
+*/
+RBMatrixVector connected_components(const RBMatrix& m,
+                                    const RBMatrixComponents& comps,
+                                    const size_t c_count);
+
+/**
+  @brief Check if \e m contains a red Σ-graph
+
+  The red edges of the active characters are packed in a matrix of blocks,
+  then every pair is checked in one tiled pass (the same test as
+  has_red_sigmapath, see rbmatrix.cpp).
+
+  @param[in] m Red-black bit-matrix
+
+  @return True if \e m contains a red Σ-graph
+*/
+bool has_red_sigmagraph(const RBMatrix& m);
+
+/**
+  @brief Check if \e m contains a red Σ-graph with characters \e c0 and \e c1
+
+  The characters are part of a red Σ-graph if they share a species through
+  red edges, and each of them has a red edge to a species that is not adjacent
+  to the other one.
+
+  @param[in] c0 Character index
+  @param[in] c1 Character index
+  @param[in] m  Red-black bit-matrix
+
+  @return True if \e m contains a red Σ-graph with characters \e c0 and \e c1
+*/
+bool has_red_sigmapath(const size_t c0, const size_t c1, const RBMatrix& m);
+
+#endif  // RBMATRIX_HPP
@@ -0,0 +1,50 @@
+#include "stats.hpp"
+#include <sstream>
+
+/**
+  @brief Names of the stages, in the order of stats::Stage
+*/
+static const char* const stage_names[] = {
+    "read_graph",    "reduce",         "maximal_reducible_graph",
+    "hasse_diagram", "initial_states", "realize"};
+
+/**
+  @brief Names of the counters, in the order of stats::Counter
+*/
+static const char* const counter_names[] = {
+    "copy_graph",   "realize",      "chains",       "test1_passed",
+    "test1_failed", "test2_passed", "test2_failed", "test3_passed",
+    "test3_failed", "sigma_checks"};
+
+static_assert(sizeof(stage_names) / sizeof(*stage_names) ==
+                  size_t(stats::Stage::size),
+              "A stage has no name");
+static_assert(sizeof(counter_names) / sizeof(*counter_names) ==
+                  size_t(stats::Counter::size),
+              "A counter has no name");
+
+std::string stats::to_json(const Stats& s, const std::string& file) {
+  std::stringstream json;
+
+  json << "{\"file\": \"";
+  for (const auto c : file) {
+    if (c == '"' || c == '\\') json << '\\';
+    json << c;
+  }
+  json << "\", \"ns\": {";
+
+  for (size_t i = 0; i < s.ns.size(); ++i) {
+    if (i > 0) json << ", ";
+    json << "\"" << stage_names[i] << "\": " << s.ns[i];
+  }
+
+  json << "}, \"counters\": {\"max_depth\": " << s.max_depth;
+
+  for (size_t i = 0; i < s.counts.size(); ++i) {
+    json << ", \"" << counter_names[i] << "\": " << s.counts[i];
+  }
+
+  json << "}}";
+
+  return json.str();
+}
@@ -0,0 +1,153 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "globals.hpp"
+
+//=============================================================================
+// Data structures
+
+namespace stats {
+
+/**
+  @brief Scoped enumeration type of the timed stages of a run
+
+  Stages are not nested, except for reduce, which is the whole reduction of
+  the input graph: the time of a stage is summed over the levels of the
+  recursion and over the threads that run it.
+*/
+enum class Stage {
+  read_graph,               ///< read_graph
+  reduce,                   ///< reduce (only the outermost call)
+  maximal_reducible_graph,  ///< maximal_reducible_graph
+  hasse_diagram,            ///< hasse_diagram
+  initial_states,           ///< initial_states, with the safe source tests
+  realize,                  ///< Realization of the safe sources in reduce
+  size                      ///< Number of stages
+};
+
+/**
+  @brief Scoped enumeration type of the counted events of a run
+*/
+enum class Counter {
+  copy_graph,    ///< Calls of copy_graph
+  realize,       ///< Realizations of a signed character
+  chains,        ///< Chains of Hasse diagrams examined by the DFS
+  test1_passed,  ///< Sources that passed the safe source test 1
+  test1_failed,  ///< Sources that failed the safe source test 1
+  test2_passed,  ///< Runs of the safe source test 2 that found a source
+  test2_failed,  ///< Runs of the safe source test 2 that found none
+  test3_passed,  ///< Runs of the safe source test 3 that found a source
+  test3_failed,  ///< Runs of the safe source test 3 that found none
+  sigma_checks,  ///< Checks for red Σ-graphs
+  size           ///< Number of counters
+};
+
+/**
+  @brief Struct used to represent the timers and the counters of a run
+
+  Everything is atomic, so the threads of the task pool update the same
+  Stats.
+*/
+struct Stats {
+  std::array<std::atomic<uint64_t>, size_t(Stage::size)> ns{};  ///< Times
+  std::array<std::atomic<uint64_t>, size_t(Counter::size)> counts{};
+  std::atomic<size_t> max_depth{};  ///< Maximum depth of the recursion
+};
+
+//=============================================================================
+// Functions
+
+/**
+  @brief Increment \e counter in the Stats of the run, if any
+
+  @param[in] counter Counter
+*/
+inline void count(const Counter counter) {
+  if (current)
+    current->counts[size_t(counter)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+  @brief Class used to add the time of a scope to a stage in the Stats of the
+         run, if any
+*/
+class Timer {
+ public:
+  /**
+    @brief Start timing \e stage, if \e enabled
+
+    @param[in] stage   Stage
+    @param[in] enabled False if the time must not be added to the stage
+  */
+  explicit Timer(const Stage stage, const bool enabled = true)
+      : stats(enabled ? current : nullptr), stage(stage) {
+    if (stats) start = std::chrono::steady_clock::now();
+  }
+
+  /**
+    @brief Add the time elapsed since the construction to the stage
+  */
+  ~Timer() {
+    if (!stats) return;
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stats->ns[size_t(stage)].fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+  }
+
+  Timer(const Timer&) = delete;
+  Timer& operator=(const Timer&) = delete;
+
+ private:
+  Stats* const stats;
+  const Stage stage;
+  std::chrono::steady_clock::time_point start{};
+};
+
+/**
+  @brief Class used to increment stats::depth in a scope, updating the
+         maximum depth in the Stats of the run, if any
+*/
+class Level {
+ public:
+  /**
+    @brief Enter a level of the recursion
+  */
+  Level() {
+    const auto d = ++depth;
+
+    if (!current) return;
+
+    auto max_depth = current->max_depth.load(std::memory_order_relaxed);
+    while (max_depth < d && !current->max_depth.compare_exchange_weak(
+                                max_depth, d, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+    @brief Leave the level of the recursion
+  */
+  ~Level() { --depth; }
+
+  Level(const Level&) = delete;
+  Level& operator=(const Level&) = delete;
+};
+
+/**
+  @brief Return \e s as a JSON object, with the name \e file
+
+  @param[in] s    Stats
+  @param[in] file Filename
+
+  @return JSON object, on a single line
+*/
+std::string to_json(const Stats& s, const std::string& file);
+
+};
+
+#endif  // STATS_HPP
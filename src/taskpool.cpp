@@ -0,0 +1,127 @@
+#include "taskpool.hpp"
+#include <cstdint>
+
+// index of the deque of the calling thread, threads outside the pool use the
+// last deque
+static thread_local size_t queue_index = SIZE_MAX;
+
+//=============================================================================
+// TaskPool
+
+TaskPool::TaskPool(const size_t n_threads) {
+  // one deque for each thread, plus the one shared by the other threads
+  for (size_t i = 0; i <= n_threads; ++i) {
+    queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue));
+  }
+
+  for (size_t i = 0; i < n_threads; ++i) {
+    threads.emplace_back(&TaskPool::work, this, i);
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    stopped = true;
+  }
+
+  idle.notify_all();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void TaskPool::submit(std::function<void()> run, TaskGroup& group) {
+  const auto index = std::min(queue_index, queues.size() - 1);
+
+  group.pending++;
+
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back({std::move(run), save_config(), &group});
+  }
+
+  {
+    // an idle thread checks queued while holding idle_mutex
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    queued++;
+  }
+
+  idle.notify_one();
+}
+
+void TaskPool::wait(TaskGroup& group) {
+  while (group.pending > 0) {
+    if (!run_one()) std::this_thread::yield();
+  }
+}
+
+bool TaskPool::run_one() {
+  const auto index = std::min(queue_index, queues.size() - 1);
+
+  Task task;
+  bool found = false;
+
+  {
+    // newest task of the calling thread
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    auto& tasks = queues[index]->tasks;
+
+    if (!tasks.empty()) {
+      task = std::move(tasks.back());
+      tasks.pop_back();
+      found = true;
+    }
+  }
+
+  for (size_t i = 1; !found && i < queues.size(); ++i) {
+    // oldest task of another thread
+    auto& queue = *queues[(index + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      found = true;
+    }
+  }
+
+  if (!found) return false;
+
+  queued--;
+
+  // run the task with the modifiers of the thread that submitted it
+  const auto config = save_config();
+  load_config(task.config);
+
+  task.run();
+
+  load_config(config);
+
+  task.group->pending--;
+
+  return true;
+}
+
+void TaskPool::work(const size_t index) {
+  queue_index = index;
+
+  while (true) {
+    if (run_one()) continue;
+
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    idle.wait(lock, [this]() { return stopped || queued > 0; });
+
+    if (stopped && queued == 0) return;
+  }
+}
+
+//=============================================================================
+// General functions
+
+TaskPool& task_pool() {
+  static TaskPool pool(parallel::threads > 1 ? parallel::threads - 1 : 0);
+
+  return pool;
+}
@@ -0,0 +1,132 @@
+#ifndef TASKPOOL_HPP
+#define TASKPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "globals.hpp"
+
+//=============================================================================
+// Data structures
+
+/**
+  @brief Struct used to count the pending tasks of a group, so that they can
+         be waited for together
+*/
+struct TaskGroup {
+  std::atomic<size_t> pending{0};  ///< Number of tasks not completed yet
+};
+
+/**
+  @brief Struct used to represent a task submitted to the pool
+*/
+struct Task {
+  std::function<void()> run{};  ///< Function run by the task
+  RunConfig config{};           ///< Modifiers of the submitting thread
+  TaskGroup* group{};           ///< Group of the task
+};
+
+/**
+  @brief Struct used to represent the deque of tasks of a thread
+*/
+struct TaskQueue {
+  std::deque<Task> tasks{};  ///< Pending tasks
+  std::mutex mutex{};        ///< Lock of tasks
+};
+
+/**
+  @brief Class used to represent a work-stealing pool of threads
+
+  Each thread of the pool has its own deque of tasks: the tasks submitted by
+  a thread are pushed at the back of its deque and run from the back (newest
+  first), while idle threads steal tasks from the front of the other deques
+  (oldest first). Threads outside the pool share one more deque.
+  A thread waiting for a group of tasks runs pending tasks in the meantime,
+  so tasks can submit other tasks and wait for them.
+  Tasks run with the modifiers (see RunConfig) of the thread that submitted
+  them.
+*/
+class TaskPool {
+ public:
+  /**
+    @brief Start a pool of \e n_threads threads
+
+    @param[in] n_threads Number of threads
+  */
+  explicit TaskPool(const size_t n_threads);
+
+  /**
+    @brief Stop the threads of the pool, after the pending tasks are run
+  */
+  ~TaskPool();
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  /**
+    @brief Submit the task \e run to the pool, as part of \e group
+
+    @param[in]     run   Function run by the task, it must not throw
+    @param[in,out] group Group of the task
+  */
+  void submit(std::function<void()> run, TaskGroup& group);
+
+  /**
+    @brief Wait for the tasks of \e group, running pending tasks meanwhile
+
+    @param[in,out] group Group of tasks
+  */
+  void wait(TaskGroup& group);
+
+  /**
+    @brief Return the number of threads of the pool
+
+    @return Number of threads
+  */
+  inline size_t size() const { return threads.size(); }
+
+ private:
+  /**
+    @brief Run one pending task, from the deque of the calling thread if
+           possible or else stolen from the other deques
+
+    @return True if a task was run
+  */
+  bool run_one();
+
+  /**
+    @brief Run pending tasks until the pool is stopped
+
+    @param[in] index Index of the deque of the thread
+  */
+  void work(const size_t index);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues{};  ///< Deque of each thread
+  std::vector<std::thread> threads{};                ///< Threads of the pool
+
+  std::atomic<size_t> queued{0};     ///< Number of pending tasks
+  std::atomic<bool> stopped{false};  ///< Stop flag
+
+  std::mutex idle_mutex{};         ///< Lock of the idle threads
+  std::condition_variable idle{};  ///< Wakes up the idle threads
+};
+
+//=============================================================================
+// General functions
+
+/**
+  @brief Return the task pool of the program
+
+  The pool is started on the first call, with parallel::threads - 1 threads
+  (the calling thread runs tasks while it waits for them).
+
+  @return Task pool
+*/
+TaskPool& task_pool();
+
+#endif  // TASKPOOL_HPP
@@ -0,0 +1,231 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+/**
+  @brief Magic bytes at the start of a trace file
+*/
+static const char trace_magic[4] = {'P', 'P', 'P', 'T'};
+
+/**
+  @brief Version of the trace format written by trace::Trace
+*/
+static constexpr uint32_t trace_version = 1;
+
+/**
+  @brief Size of an event in a trace file
+*/
+static constexpr size_t event_size = 32;
+
+/**
+  @brief Names of the types, in the order of trace::Type
+*/
+static const char* const type_names[] = {
+    "run_begin", "run_end", "reduce_begin", "reduce_end", "realize",
+    "components", "hasse", "chain", "sources"};
+
+static_assert(sizeof(type_names) / sizeof(*type_names) ==
+                  size_t(trace::Type::size),
+              "A type has no name");
+
+/**
+  @brief Return the nanoseconds of the steady clock
+
+  @return Nanoseconds
+*/
+static uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+  @brief Return the index of the calling thread, assigned the first time it
+         records an event
+
+  @return Index of the thread
+*/
+static uint16_t thread_index() {
+  static std::atomic<uint16_t> next{0};
+  thread_local const uint16_t index = next++;
+
+  return index;
+}
+
+/**
+  @brief Append \e value to \e out, in \e size little-endian bytes
+
+  @param[in]     value Value
+  @param[in]     size  Number of bytes
+  @param[in,out] out   Output bytes
+*/
+static void put_le(const uint64_t value, const size_t size, std::string& out) {
+  for (size_t i = 0; i < size; ++i) {
+    out += static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+/**
+  @brief Return the value stored in the \e size little-endian bytes at \e p
+
+  @param[in] p    Bytes
+  @param[in] size Number of bytes
+
+  @return Value
+*/
+static uint64_t get_le(const unsigned char* p, const size_t size) {
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < size; ++i) {
+    value |= uint64_t(p[i]) << (8 * i);
+  }
+
+  return value;
+}
+
+//=============================================================================
+// Trace
+
+trace::Trace::Trace(const std::string& filename, const size_t capacity)
+    : file(filename, std::ios::binary),
+      capacity(std::max<size_t>(1, capacity)),
+      start(now_ns()) {
+  std::string header(trace_magic, sizeof(trace_magic));
+  put_le(trace_version, 4, header);
+  file.write(header.data(), header.size());
+
+  if (!file) {
+    // output file error
+    throw std::runtime_error("Failed to write trace to file: " + filename);
+  }
+
+  buffer.reserve(this->capacity);
+}
+
+trace::Trace::~Trace() {
+  std::lock_guard<std::mutex> lock(mutex);
+  flush();
+}
+
+void trace::Trace::record(const Type type, const uint64_t a, const uint64_t b,
+                          const std::string& name) {
+  Event event;
+  event.ns = now_ns() - start;
+  event.run = trace::run;
+  event.thread = thread_index();
+  event.type = type;
+  event.depth = static_cast<uint8_t>(std::min<size_t>(stats::depth, 255));
+  event.a = a;
+  event.b = b;
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  buffer.push_back(event);
+  if (type == Type::run_begin) names.push_back(name);
+
+  if (buffer.size() == capacity) flush();
+}
+
+void trace::Trace::flush() {
+  std::string out;
+  out.reserve(buffer.size() * event_size);
+  size_t name = 0;
+
+  for (const auto& event : buffer) {
+    put_le(event.ns, 8, out);
+    put_le(event.run, 4, out);
+    put_le(event.thread, 2, out);
+    put_le(static_cast<uint8_t>(event.type), 1, out);
+    put_le(event.depth, 1, out);
+
+    if (event.type == Type::run_begin) {
+      // the name follows the event, its size replaces the argument b
+      put_le(event.a, 8, out);
+      put_le(names[name].size(), 8, out);
+      out += names[name++];
+    } else {
+      put_le(event.a, 8, out);
+      put_le(event.b, 8, out);
+    }
+  }
+
+  file.write(out.data(), out.size());
+  file.flush();
+
+  buffer.clear();
+  names.clear();
+}
+
+//=============================================================================
+// Functions
+
+const char* trace::type_name(const Type type) {
+  return (type < Type::size ? type_names[size_t(type)] : "unknown");
+}
+
+void trace::read_trace(const std::string& filename, std::vector<Event>& events,
+                       std::vector<std::string>& names) {
+  std::ifstream file(filename, std::ios::binary);
+
+  if (!file) {
+    // input file doesn't exist
+    throw std::runtime_error(
+        "Failed to read trace from file: no such file or directory");
+  }
+
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+  const auto* const end = p + data.size();
+
+  if (data.size() < 8 ||
+      std::memcmp(p, trace_magic, sizeof(trace_magic)) != 0) {
+    // input file parsing error
+    throw std::runtime_error("Failed to read trace from file: not a trace");
+  }
+
+  if (get_le(p + 4, 4) != trace_version) {
+    // input file parsing error
+    throw std::runtime_error(
+        "Failed to read trace from file: unsupported trace format version");
+  }
+
+  events.clear();
+  names.clear();
+
+  for (p += 8; p != end;) {
+    if (size_t(end - p) < event_size) {
+      // input file parsing error
+      throw std::runtime_error(
+          "Failed to read trace from file: truncated event");
+    }
+
+    Event event;
+    event.ns = get_le(p, 8);
+    event.run = get_le(p + 8, 4);
+    event.thread = get_le(p + 12, 2);
+    event.type = static_cast<Type>(p[14]);
+    event.depth = p[15];
+    event.a = get_le(p + 16, 8);
+    event.b = get_le(p + 24, 8);
+    p += event_size;
+
+    if (event.type == Type::run_begin) {
+      if (event.b > size_t(end - p)) {
+        // input file parsing error
+        throw std::runtime_error(
+            "Failed to read trace from file: truncated name");
+      }
+
+      if (names.size() <= event.a) names.resize(event.a + 1);
+      names[event.a].assign(reinterpret_cast<const char*>(p), event.b);
+      p += event.b;
+    }
+
+    events.push_back(event);
+  }
+}
@@ -0,0 +1,149 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "globals.hpp"
+
+//=============================================================================
+// Data structures
+
+namespace trace {
+
+/**
+  @brief Scoped enumeration type of the events of a trace
+
+  The meaning of the arguments a and b of each event is:
+  - run_begin: index of the run, size of its name (which follows the event);
+  - run_end: index of the run, 1 if the graph was reduced;
+  - reduce_begin: species and characters of the graph;
+  - reduce_end: 1 if the graph was reduced, length of the reduction;
+  - realize: character, 0 for + or 1 for -, plus 2 if it was feasible;
+  - components: number of connected components, vertices of the graph;
+  - hasse: vertices and edges of the Hasse diagram;
+  - chain: edges of the chain, 1 if it is safe;
+  - sources: number of safe sources, index of the one realized (the number
+    of safe sources if they are all tested).
+*/
+enum class Type : uint8_t {
+  run_begin,
+  run_end,
+  reduce_begin,
+  reduce_end,
+  realize,
+  components,
+  hasse,
+  chain,
+  sources,
+  size  ///< Number of types
+};
+
+/**
+  @brief Struct used to represent an event of a trace
+
+  Events are stored in the trace file as 32 little-endian bytes, in the
+  order of the fields.
+*/
+struct Event {
+  uint64_t ns{};      ///< Nanoseconds since the start of the trace
+  uint32_t run{};     ///< Index of the run (input file)
+  uint16_t thread{};  ///< Index of the thread
+  Type type{};        ///< Type
+  uint8_t depth{};    ///< Depth of the reduction recursion (at most 255)
+  uint64_t a{};       ///< First argument
+  uint64_t b{};       ///< Second argument
+};
+
+/**
+  @brief Class used to write a binary trace of the reduction to a file
+
+  Events are appended to a fixed-size buffer, which is written to the file
+  each time it fills up, so recording an event is a copy under a lock.
+  The same Trace is shared by all the threads of a run.
+*/
+class Trace {
+ public:
+  /**
+    @brief Open \e filename and write the header of the trace
+
+    Throws std::runtime_error if \e filename can't be written.
+
+    @param[in] filename Filename
+    @param[in] capacity Number of events kept in the buffer
+  */
+  explicit Trace(const std::string& filename, const size_t capacity = 4096);
+
+  /**
+    @brief Write the buffered events and close the file
+  */
+  ~Trace();
+
+  Trace(const Trace&) = delete;
+  Trace& operator=(const Trace&) = delete;
+
+  /**
+    @brief Append an event of type \e type to the trace
+
+    @param[in] type Type
+    @param[in] a    First argument
+    @param[in] b    Second argument
+    @param[in] name Name written after the event (only for run_begin)
+  */
+  void record(const Type type, const uint64_t a, const uint64_t b,
+              const std::string& name = "");
+
+ private:
+  /**
+    @brief Write the buffered events to the file (the lock must be held)
+  */
+  void flush();
+
+  std::ofstream file{};              ///< Trace file
+  size_t capacity{};                 ///< Capacity of the buffer
+  std::vector<Event> buffer{};       ///< Buffered events
+  std::vector<std::string> names{};  ///< Names of the buffered runs
+  std::mutex mutex{};                ///< Lock of the buffer and the file
+  uint64_t start{};                  ///< Start of the trace (nanoseconds)
+};
+
+//=============================================================================
+// Functions
+
+/**
+  @brief Append an event to the trace of the run, if any
+
+  @param[in] type Type
+  @param[in] a    First argument
+  @param[in] b    Second argument
+*/
+inline void record(const Type type, const uint64_t a, const uint64_t b = 0) {
+  if (current) current->record(type, a, b);
+}
+
+/**
+  @brief Return the name of \e type
+
+  @param[in] type Type
+
+  @return Name
+*/
+const char* type_name(const Type type);
+
+/**
+  @brief Read the trace in \e filename
+
+  Throws std::runtime_error if \e filename is not a trace or is truncated.
+
+  @param[in]  filename Filename
+  @param[out] events   Events, in the order they were recorded
+  @param[out] names    Names of the runs, by index
+*/
+void read_trace(const std::string& filename, std::vector<Event>& events,
+                std::vector<std::string>& names);
+
+};
+
+#endif  // TRACE_HPP
@@ -45,6 +45,18 @@ int main(int argc, const char* argv[]) {
   assert(!is_active(s5, g));
   assert(is_active(c4, g));
 
+  // degree counters follow edge changes
+  assert(red_degree(c4, g) == 3 && black_degree(c4, g) == 0);
+  assert(red_degree(s5, g) == 1 && black_degree(s5, g) == 5);
+
+  change_char_type(c4, g);
+  assert(!is_active(c4, g));
+  assert(black_degree(c4, g) == 3 && black_degree(s5, g) == 6);
+
+  clear_vertex(c4, g);
+  assert(is_active(c4, g));
+  assert(black_degree(c4, g) == 0 && black_degree(s5, g) == 5);
+
   std::cout << "active: tests passed" << std::endl;
 
   return 0;
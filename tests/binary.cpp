@@ -0,0 +1,52 @@
+#include "functions.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g, g_binary, g_text;
+
+  read_graph("tests/test_6x3.txt", g);
+  change_char_type(get_vertex("c1", g), g);
+
+  std::stringstream g_str;
+  g_str << g;
+
+  // text -> binary -> text
+  write_graph("tests/binary.bin", g, true);
+  read_graph("tests/binary.bin", g_binary);
+  write_graph("tests/binary.txt", g_binary);
+  read_graph("tests/binary.txt", g_text);
+
+  std::stringstream g_binary_str, g_text_str;
+  g_binary_str << g_binary;
+  g_text_str << g_text;
+
+  assert(g_binary_str.str() == g_str.str());
+  assert(g_text_str.str() == g_str.str());
+  assert(is_active(get_vertex("c1", g_binary), g_binary));
+
+  // corrupted binary file
+  std::fstream file("tests/binary.bin",
+                    std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(-1, std::ios::end);
+  file.put('\x7f');
+  file.close();
+
+  RBGraph g_corrupted;
+
+  try {
+    read_graph("tests/binary.bin", g_corrupted);
+    assert(false);
+  } catch (const std::runtime_error& e) {
+    assert(std::string(e.what()).find("checksum") != std::string::npos);
+  }
+
+  std::remove("tests/binary.bin");
+  std::remove("tests/binary.txt");
+
+  std::cout << "binary: tests passed" << std::endl;
+
+  return 0;
+}
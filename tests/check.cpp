@@ -0,0 +1,66 @@
+#include "functions.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g;
+  RBMatrix m;
+
+  read_graph("tests/test_5x2.txt", g);
+  copy_graph(g, m);
+
+  const auto c0 = g[get_vertex("c0", g)].id;
+  const auto c1 = g[get_vertex("c1", g)].id;
+
+  // successful c-reduction
+  assert(check_reduction(m, { { c1, State::gain },
+                              { c0, State::gain },
+                              { c1, State::lose } }) == true);
+
+  // incomplete c-reduction
+  assert(check_reduction(m, { { c1, State::gain },
+                              { c0, State::gain } }) == false);
+
+  // c1- is not feasible while c1 is inactive
+  assert(check_reduction(m, { { c1, State::lose },
+                              { c1, State::gain },
+                              { c0, State::gain },
+                              { c1, State::lose } }) == false);
+
+  // c0+ alone reduces the matrix made up of c0 only
+  assert(check_reduction(m, { { c0, State::gain } }, { c0 }) == true);
+  assert(check_reduction(m, { { c0, State::gain } }) == false);
+
+  // the reduction computed by the algorithm
+  assert(check_reduction(m, reduce(g)) == true);
+
+  // the same reduction, without exceptions
+  RBGraph g_try;
+  read_graph("tests/test_5x2.txt", g_try);
+
+  std::list<SignedCharacter> reduction;
+  bool reducible = false;
+  std::tie(reduction, reducible) = try_reduce(g_try);
+
+  assert(reducible == true);
+  assert(check_reduction(m, reduction) == true);
+
+  // a graph that can't be reduced
+  RBGraph g_no;
+  RBMatrix m_no;
+  read_graph("tests/test_6x3.txt", g_no);
+  copy_graph(g_no, m_no);
+
+  std::tie(reduction, reducible) = try_reduce(g_no);
+
+  assert(reducible == false);
+  assert(reduction.empty());
+
+  std::tie(reduction, reducible) = try_reduce(m_no);
+
+  assert(reducible == false);
+  assert(reduction.empty());
+
+  std::cout << "check: tests passed" << std::endl;
+
+  return 0;
+}
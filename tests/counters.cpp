@@ -0,0 +1,36 @@
+#include "functions.hpp"
+#include "stats.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g;
+  read_graph("tests/test_5x2.txt", g);
+
+  // nothing is counted without the Stats of a run
+  reduce(g);
+
+  stats::Stats run_stats;
+  stats::current = &run_stats;
+
+  RBGraph g_stats;
+  read_graph("tests/test_5x2.txt", g_stats);
+  reduce(g_stats);
+
+  stats::current = nullptr;
+
+  assert(stats::depth == 0);
+  assert(run_stats.max_depth >= 2);
+  assert(run_stats.ns[size_t(stats::Stage::reduce)] > 0);
+  assert(run_stats.ns[size_t(stats::Stage::read_graph)] == 0);
+  assert(run_stats.counts[size_t(stats::Counter::realize)] > 0);
+  assert(run_stats.counts[size_t(stats::Counter::chains)] > 0);
+  assert(run_stats.counts[size_t(stats::Counter::test1_passed)] > 0);
+
+  const auto json = stats::to_json(run_stats, "tests/test_5x2.txt");
+  assert(json.find("\"file\": \"tests/test_5x2.txt\"") != std::string::npos);
+  assert(json.find("\"sigma_checks\": ") != std::string::npos);
+
+  std::cout << "counters: tests passed" << std::endl;
+
+  return 0;
+}
@@ -11,19 +11,22 @@ int main(int argc, const char* argv[]) {
   v3 = add_vertex("v3", g);
   v4 = add_vertex("v4", g);
 
-  RBVertexNameMap& v_map = vertex_map(g);
-
   assert(num_vertices(g) == 5);
-  assert(v_map.at("v0") == v0 && g[v0].name == "v0");
-  assert(v_map.at("v1") == v1 && g[v1].name == "v1");
-  assert(v_map.at("v2") == v2 && g[v2].name == "v2");
-  assert(v_map.at("v3") == v3 && g[v3].name == "v3");
-  assert(v_map.at("v4") == v4 && g[v4].name == "v4");
+  assert(get_vertex("v0", g) == v0 && get_name(v0, g) == "v0");
+  assert(get_vertex("v1", g) == v1 && get_name(v1, g) == "v1");
+  assert(get_vertex("v2", g) == v2 && get_name(v2, g) == "v2");
+  assert(get_vertex("v3", g) == v3 && get_name(v3, g) == "v3");
+  assert(get_vertex("v4", g) == v4 && get_name(v4, g) == "v4");
+
+  // IDs are dense and assigned in order
+  assert(g[v0].id == 0 && g[v4].id == 4);
+  assert(get_vertex(g[v2].id, Type::species, g) == v2);
+  assert(intern_name("v2", Type::species) == g[v2].id);
 
   remove_vertex(v4, g);
 
   try {
-    v_map.at("v4");
+    get_vertex("v4", g);
   }
   catch (const std::out_of_range& e) {
     assert(num_vertices(g) == 4);
@@ -32,7 +35,7 @@ int main(int argc, const char* argv[]) {
   remove_vertex("v3", g);
 
   try {
-    v_map.at("v3");
+    get_vertex("v3", g);
   }
   catch (const std::out_of_range& e) {
     assert(num_vertices(g) == 3);
@@ -41,7 +44,8 @@ int main(int argc, const char* argv[]) {
   v3 = add_vertex("v3", g);
   v4 = add_vertex("v3", g);
 
-  assert(v_map.at("v3") == v3 && g[v3].name == "v3");
+  assert(get_vertex("v3", g) == v3 && get_name(v3, g) == "v3");
+  assert(g[v3].id == 3);
   assert(v3 == v4);
 
   std::cout << "map: tests passed" << std::endl;
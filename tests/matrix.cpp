@@ -0,0 +1,85 @@
+#include "rbmatrix.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g, g1;
+  RBMatrix m, m1;
+  RBMatrixComponents comps;
+  RBVertex s3, s4, s5,
+           c1, c2, c3, c4, c5, c7;
+
+  s3 = add_vertex("s3", Type::species, g);
+  s4 = add_vertex("s4", Type::species, g);
+  s5 = add_vertex("s5", Type::species, g);
+  c1 = add_vertex("c1", Type::character, g);
+  c2 = add_vertex("c2", Type::character, g);
+  c3 = add_vertex("c3", Type::character, g);
+  c4 = add_vertex("c4", Type::character, g);
+  c5 = add_vertex("c5", Type::character, g);
+       add_vertex("c6", Type::character, g);
+  c7 = add_vertex("c7", Type::character, g);
+       add_vertex("c8", Type::character, g);
+
+  add_edge(s3, c2, g);
+  add_edge(s3, c3, g);
+  add_edge(s3, c4, Color::red, g);
+  add_edge(s4, c1, g);
+  add_edge(s4, c2, g);
+  add_edge(s4, c4, Color::red, g);
+  add_edge(s5, c1, g);
+  add_edge(s5, c2, g);
+  add_edge(s5, c3, g);
+  add_edge(s5, c4, Color::red, g);
+  add_edge(s5, c5, g);
+  add_edge(s5, c7, g);
+
+  copy_graph(g, m);
+
+  assert(num_species(m) == 3);
+  assert(num_characters(m) == 8);
+  assert(is_active(get_character(g[c4].id, m), m) == true);
+  assert(is_inactive(get_character(g[c4].id, m), m) == false);
+
+  // c6 and c8 are on their own
+  assert(connected_components(m, comps) == 3);
+  assert(is_free(get_character(g[c4].id, m), m, comps) == true);
+  assert(is_free(get_character(g[c5].id, m), m, comps) == false);
+  assert(is_universal(get_character(g[c2].id, m), m, comps) == true);
+  assert(is_universal(get_character(g[c4].id, m), m, comps) == false);
+  assert(connected_components(m, comps, 3).size() == 3);
+
+  remove_singletons(m);
+  assert(num_characters(m) == 6);
+  assert(connected_components(m, comps) == 1);
+
+  // the matrix converts back to the same graph
+  copy_graph(m, g1);
+  remove_singletons(g);
+  assert(num_vertices(g1) == num_vertices(g));
+  assert(num_edges(g1) == num_edges(g));
+
+  // c1 and c2 form a red Σ-graph once they are made active
+  const auto m_c1 = get_character(g[c1].id, m);
+  const auto m_c2 = get_character(g[c2].id, m);
+
+  clear_character(get_character(g[c3].id, m), m);
+  clear_character(get_character(g[c4].id, m), m);
+  clear_character(get_character(g[c5].id, m), m);
+  clear_character(get_character(g[c7].id, m), m);
+  clear_character(m_c1, m);
+  clear_character(m_c2, m);
+  add_edge(g[s3].id, m_c1, Color::red, m);
+  add_edge(g[s4].id, m_c1, Color::red, m);
+  add_edge(g[s4].id, m_c2, Color::red, m);
+  add_edge(g[s5].id, m_c2, Color::red, m);
+  assert(has_red_sigmagraph(m) == true);
+  assert(has_red_sigmapath(m_c1, m_c2, m) == true);
+
+  remove_edge(g[s5].id, m_c2, m);
+  assert(has_red_sigmagraph(m) == false);
+  assert(is_empty(m1) == true);
+
+  std::cout << "matrix: tests passed" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+#include <sstream>
+#include "rbgraph.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g;
+
+  // vertices added out of order, sorted by the number in their names
+  const auto s10 = add_vertex("s10", Type::species, g);
+  const auto s2 = add_vertex("s2", Type::species, g);
+  const auto c1 = add_vertex("c1", Type::character, g);
+  const auto c0 = add_vertex("c0", Type::character, g);
+
+  add_edge(s10, c1, g);
+  add_edge(s10, c0, Color::red, g);
+  add_edge(s2, c0, g);
+
+  // the last vertex added (c0) has no newline
+  const std::string expected =
+      "s2: --- c0;\n"
+      "s10: -r- c0; --- c1;\n"
+      "c0: --- s2; -r- s10;"
+      "c1: --- s10;\n";
+
+  std::stringstream buffered, streamed, op;
+  print_adjacency(buffered, g);
+  print_adjacency(streamed, g, true);
+  op << g;
+
+  assert(buffered.str() == expected);
+  assert(streamed.str() == expected);
+  assert(op.str() == expected);
+
+  std::cout << "print: tests passed" << std::endl;
+
+  return 0;
+}
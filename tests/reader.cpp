@@ -0,0 +1,60 @@
+#include "container.hpp"
+#include "functions.hpp"
+#include <cstdio>
+#include <sstream>
+
+
+int main(int argc, const char* argv[]) {
+  write_container("tests/reader.ppc",
+                  {"tests/test_5x2.txt", "tests/test_6x3.txt"});
+
+  // container, then a plain input file, read without and with prefetching
+  for (const size_t prefetch : {0, 2}) {
+    InstanceReader reader({"tests/reader.ppc", "tests/test_6x3.txt"}, 0,
+                          SIZE_MAX, prefetch);
+
+    assert(reader.size() == 3);
+    assert(reader.has_containers());
+    assert(reader.name(0) == "tests/reader.ppc:0");
+    assert(reader.name(2) == "tests/test_6x3.txt");
+
+    Instance instance;
+    const std::vector<std::string> files{
+        "tests/test_5x2.txt", "tests/test_6x3.txt", "tests/test_6x3.txt"};
+
+    for (const auto& file : files) {
+      assert(reader.next(instance));
+      assert(instance.error.empty());
+
+      RBGraph g, g_instance;
+      read_graph(file, g);
+
+      if (instance.contained)
+        read_graph(instance.data.data(), instance.data.size(), g_instance);
+      else
+        read_graph(instance.name, g_instance);
+
+      std::stringstream g_str, g_instance_str;
+      g_str << g;
+      g_instance_str << g_instance;
+
+      assert(g_instance_str.str() == g_str.str());
+    }
+
+    assert(!reader.next(instance));
+  }
+
+  // range of instances
+  InstanceReader reader({"tests/reader.ppc", "tests/reader.ppc"}, 1, 3,
+                        0);
+
+  assert(reader.size() == 2);
+  assert(reader.name(0) == "tests/reader.ppc:1");
+  assert(reader.name(1) == "tests/reader.ppc:0");
+
+  std::remove("tests/reader.ppc");
+
+  std::cout << "reader: tests passed" << std::endl;
+
+  return 0;
+}
@@ -44,13 +44,15 @@ int main(int argc, const char* argv[]) {
   RBGraph g1;
   copy_graph(g, g1);
 
-  realize({ "c3", State::gain }, g);
-  realize({ "c5", State::gain }, g);
-  realize({ "c2", State::gain }, g);
-  realize({ "c4", State::lose }, g);
+  realize({ g[c3].id, State::gain }, g);
+  realize({ g[c5].id, State::gain }, g);
+  realize({ g[c2].id, State::gain }, g);
+  realize({ g[c4].id, State::lose }, g);
 
-  realize({ { "c3", State::gain }, { "c5", State::gain },
-            { "c2", State::gain }, { "c4", State::lose } }, g1);
+  realize({ { g1[get_vertex("c3", g1)].id, State::gain },
+            { g1[get_vertex("c5", g1)].id, State::gain },
+            { g1[get_vertex("c2", g1)].id, State::gain },
+            { g1[get_vertex("c4", g1)].id, State::lose } }, g1);
 
   assert(num_species(g) == num_species(g1));
   assert(num_characters(g) == num_characters(g1));
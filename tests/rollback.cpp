@@ -0,0 +1,87 @@
+#include "functions.hpp"
+#include <sstream>
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g;
+  RBVertex s1, s2, s3, s4, s5, s6,
+           c1, c2, c3, c4, c5, c6, c7, c8;
+
+  s1 = add_vertex("s1", Type::species, g);
+  s2 = add_vertex("s2", Type::species, g);
+  s3 = add_vertex("s3", Type::species, g);
+  s4 = add_vertex("s4", Type::species, g);
+  s5 = add_vertex("s5", Type::species, g);
+  s6 = add_vertex("s6", Type::species, g);
+  c1 = add_vertex("c1", Type::character, g);
+  c2 = add_vertex("c2", Type::character, g);
+  c3 = add_vertex("c3", Type::character, g);
+  c4 = add_vertex("c4", Type::character, g);
+  c5 = add_vertex("c5", Type::character, g);
+  c6 = add_vertex("c6", Type::character, g);
+  c7 = add_vertex("c7", Type::character, g);
+  c8 = add_vertex("c8", Type::character, g);
+
+  add_edge(s1, c8, g);
+  add_edge(s2, c3, g);
+  add_edge(s2, c5, g);
+  add_edge(s2, c6, g);
+  add_edge(s3, c2, g);
+  add_edge(s3, c3, g);
+  add_edge(s3, c4, Color::red, g);
+  add_edge(s4, c1, g);
+  add_edge(s4, c2, g);
+  add_edge(s4, c4, Color::red, g);
+  add_edge(s5, c1, g);
+  add_edge(s5, c2, g);
+  add_edge(s5, c3, g);
+  add_edge(s5, c4, Color::red, g);
+  add_edge(s5, c5, g);
+  add_edge(s5, c7, g);
+  add_edge(s6, c2, g);
+  add_edge(s6, c3, g);
+  add_edge(s6, c5, g);
+
+  std::stringstream g_before, g_after;
+  g_before << g;
+
+  const auto n_components = num_components(g);
+  const auto n_edges = num_edges(g);
+
+  // nested checkpoints
+  const auto cp0 = checkpoint(g);
+
+  realize({ g[c3].id, State::gain }, g);
+
+  const auto cp1 = checkpoint(g);
+
+  realize({ g[c5].id, State::gain }, g);
+  realize({ g[c2].id, State::gain }, g);
+  realize({ g[c4].id, State::lose }, g);
+  change_char_type(c1, g);
+
+  rollback(cp1, g);
+  assert(is_inactive(c5, g) && is_inactive(c2, g) && is_active(c4, g));
+
+  rollback(cp0, g);
+  g_after << g;
+
+  // same vertices, descriptors and edges
+  assert(g_before.str() == g_after.str());
+  assert(num_species(g) == 6 && num_characters(g) == 8);
+  assert(num_edges(g) == n_edges);
+  assert(num_components(g) == n_components);
+  assert(get_vertex("c4", g) == c4);
+  assert(red_degree(s5, g) == 1 && black_degree(s5, g) == 5);
+  assert(*vertices(g).first == s1);
+
+  // changes are not recorded once every checkpoint is rolled back
+  clear_vertex(c8, g);
+  rollback(cp0, g);
+  assert(out_degree(c8, g) == 0);
+  assert(out_degree(s1, g) == 0);
+
+  std::cout << "rollback: tests passed" << std::endl;
+
+  return 0;
+}
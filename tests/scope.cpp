@@ -0,0 +1,63 @@
+#include "arena.hpp"
+#include "functions.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  // containers built outside any scope allocate from the heap
+  assert(arena::scoped() == nullptr);
+  assert(arena::List<size_t>().get_allocator().arena == nullptr);
+
+  arena::Arena a(64);
+
+  auto* const p = a.allocate(10, 1);
+  const auto m = a.mark();
+  auto* const q = a.allocate(8, 8);
+  assert(reinterpret_cast<uintptr_t>(q) % 8 == 0);
+
+  // everything after the mark is freed, and the memory is reused
+  a.release(m);
+  assert(a.allocate(8, 8) == q);
+
+  // requests bigger than a block get their own block
+  a.allocate(1000, 16);
+  const auto capacity = a.capacity();
+  assert(capacity >= 1000 + 64);
+
+  a.reset();
+  assert(a.allocate(10, 1) == p);
+  assert(a.capacity() == capacity);
+
+  // each level of the reduction allocates its temporaries from the arena of
+  // the thread, and frees them at its end
+  arena::Arena* level_arena = nullptr;
+  size_t level_capacity = 0;
+
+  for (size_t i = 0; i < 2; ++i) {
+    const arena::Scope scope;
+    level_arena = arena::scoped();
+    assert(level_arena != nullptr);
+
+    RBGraph g;
+    read_graph("tests/test_5x2.txt", g);
+
+    auto gm = maximal_reducible_graph(g, true);
+
+    HDGraph p;
+    hasse_diagram(p, g, gm);
+
+    assert(num_vertices(p) > 0);
+    assert(p[*vertices(p).first].species.get_allocator().arena ==
+           level_arena);
+
+    if (i == 0) level_capacity = level_arena->capacity();
+
+    // the second level reuses the memory of the first one
+    assert(level_arena->capacity() == level_capacity);
+  }
+
+  assert(arena::scoped() == nullptr);
+
+  std::cout << "scope: tests passed" << std::endl;
+
+  return 0;
+}
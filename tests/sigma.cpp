@@ -0,0 +1,56 @@
+#include "functions.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  RBGraph g;
+  RBVertex s1, s2, s3, s4,
+           c1, c2, c3;
+
+  s1 = add_vertex("s1", Type::species, g);
+  s2 = add_vertex("s2", Type::species, g);
+  s3 = add_vertex("s3", Type::species, g);
+  s4 = add_vertex("s4", Type::species, g);
+  c1 = add_vertex("c1", Type::character, g);
+  c2 = add_vertex("c2", Type::character, g);
+  c3 = add_vertex("c3", Type::character, g);
+
+  add_edge(s1, c1, Color::red, g);
+  add_edge(s2, c1, Color::red, g);
+  add_edge(s2, c2, Color::red, g);
+  assert(has_red_sigmagraph(g) == false);
+
+  // c1 and c2 share s2, and each has a species the other doesn't have
+  add_edge(s3, c2, Color::red, g);
+  assert(has_red_sigmagraph(g) == true);
+  assert(has_red_sigmapath(c1, c2, g) == true);
+  assert(red_sigmagraph_pairs(g).size() == 1);
+  assert(red_sigmagraph_pairs(g).count({g[c1].id, g[c2].id}) == 1);
+
+  // the same pairs are found in copies
+  RBGraph g_copy;
+  copy_graph(g, g_copy);
+  assert(red_sigmagraph_pairs(g_copy) == red_sigmagraph_pairs(g));
+
+  // changes are undone by rollback
+  const auto cp = checkpoint(g);
+
+  remove_edge(edge(s1, c1, g).first, g);
+  assert(has_red_sigmagraph(g) == false);
+
+  add_edge(s4, c3, Color::red, g);
+  add_edge(s3, c3, Color::red, g);
+  assert(red_sigmagraph_pairs(g).size() == 1);
+  assert(red_sigmagraph_pairs(g).count({g[c2].id, g[c3].id}) == 1);
+
+  // c2 is no longer active
+  change_char_type(c2, g);
+  assert(has_red_sigmagraph(g) == false);
+
+  rollback(cp, g);
+  assert(red_sigmagraph_pairs(g).size() == 1);
+  assert(red_sigmagraph_pairs(g).count({g[c1].id, g[c2].id}) == 1);
+
+  std::cout << "sigma: tests passed" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstdio>
+#include "functions.hpp"
+#include "trace.hpp"
+
+
+int main(int argc, const char* argv[]) {
+  {
+    // a small buffer, so the events are flushed while recording
+    trace::Trace run_trace("tests/tracing.ppt", 3);
+    trace::current = &run_trace;
+    trace::run = 1;
+
+    run_trace.record(trace::Type::run_begin, trace::run, 0, "test_5x2");
+
+    RBGraph g;
+    read_graph("tests/test_5x2.txt", g);
+    reduce(g);
+
+    trace::record(trace::Type::run_end, trace::run, true);
+
+    trace::current = nullptr;
+    trace::run = 0;
+  }
+
+  std::vector<trace::Event> events;
+  std::vector<std::string> names;
+  trace::read_trace("tests/tracing.ppt", events, names);
+
+  std::remove("tests/tracing.ppt");
+
+  assert(names.size() == 2);
+  assert(names[1] == "test_5x2");
+
+  assert(events.front().type == trace::Type::run_begin);
+  assert(events.front().a == 1);
+  assert(events.back().type == trace::Type::run_end);
+  assert(events.back().b == 1);
+
+  const auto count = [&](const trace::Type type) {
+    return std::count_if(
+        events.cbegin(), events.cend(),
+        [&](const trace::Event& event) { return event.type == type; });
+  };
+
+  // every level of the recursion begins and ends
+  assert(count(trace::Type::reduce_begin) > 1);
+  assert(count(trace::Type::reduce_begin) == count(trace::Type::reduce_end));
+  assert(count(trace::Type::realize) > 0);
+  assert(count(trace::Type::hasse) > 0);
+
+  // the outermost level is the first, at depth 1, and reduces the graph
+  const auto first = std::find_if(
+      events.cbegin(), events.cend(), [](const trace::Event& event) {
+        return event.type == trace::Type::reduce_begin;
+      });
+  assert(first->depth == 1);
+  assert(first->a == 5 && first->b == 2);
+
+  for (size_t i = 1; i < events.size(); ++i) {
+    assert(events[i].run == 1);
+    assert(events[i - 1].ns <= events[i].ns);
+  }
+
+  std::cout << "tracing: tests passed" << std::endl;
+
+  return 0;
+}